@@ -0,0 +1,827 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: http://www.viva64.com
+
+#include "Accuracy.h"
+#include "ClosestPoint.h"
+#include "Spline.h"
+#include "Vector.h"
+#include "VectorBatch.h"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <random>
+
+//Vector of long doubles for the references, products and sums of a few floats are exact or nearly so in it
+template <int N>
+struct Exact
+{
+	long double v[N];
+
+	Exact operator + (const Exact& p) const
+	{
+		Exact result;
+		for (int i = 0; i < N; i++) result.v[i] = v[i] + p.v[i];
+		return result;
+	}
+
+	Exact operator - (const Exact& p) const
+	{
+		Exact result;
+		for (int i = 0; i < N; i++) result.v[i] = v[i] - p.v[i];
+		return result;
+	}
+
+	Exact operator * (const long double p) const
+	{
+		Exact result;
+		for (int i = 0; i < N; i++) result.v[i] = v[i] * p;
+		return result;
+	}
+};
+
+template <int N>
+static Exact<N> LoadExact(const float* inputs)
+{
+	Exact<N> result;
+	for (int i = 0; i < N; i++) result.v[i] = inputs[i];
+	return result;
+}
+
+template <int N>
+static void StoreExact(long double* outputs, const Exact<N>& vector)
+{
+	for (int i = 0; i < N; i++) outputs[i] = vector.v[i];
+}
+
+template <int N>
+static long double Dot(const Exact<N>& lhs, const Exact<N>& rhs)
+{
+	long double result = 0;
+	for (int i = 0; i < N; i++) result += lhs.v[i] * rhs.v[i];
+	return result;
+}
+
+template <int N>
+static long double Length(const Exact<N>& vector)
+{
+	return sqrtl(Dot(vector, vector));
+}
+
+static Exact<3> Cross(const Exact<3>& lhs, const Exact<3>& rhs)
+{
+	return { { lhs.v[1] * rhs.v[2] - lhs.v[2] * rhs.v[1], lhs.v[2] * rhs.v[0] - lhs.v[0] * rhs.v[2], lhs.v[0] * rhs.v[1] - lhs.v[1] * rhs.v[0] } };
+}
+
+static long double ClampExact(long double x, const long double min, const long double max)
+{
+	if (x < min) x = min;
+	else if (x > max) x = max;
+	return x;
+}
+
+static long double TriangleAreaExact(const Exact<3>& a, const Exact<3>& b, const Exact<3>& c)
+{
+	return Length(Cross(a - c, b - c)) / 2;
+}
+
+static long double TriangleAreaExact(const Exact<2>& a, const Exact<2>& b, const Exact<2>& c)
+{
+	return fabsl(a.v[0] * (b.v[1] - c.v[1]) + b.v[0] * (c.v[1] - a.v[1]) + c.v[0] * (a.v[1] - b.v[1])) / 2;
+}
+
+//Point is inside when the areas of the three triangles it forms with the edges add up to the area of the triangle
+template <int N>
+static bool InsideExact(const Exact<N>& point, const Exact<N>& a, const Exact<N>& b, const Exact<N>& c)
+{
+	const long double area = TriangleAreaExact(a, b, c);
+	const long double sum = TriangleAreaExact(point, b, c) + TriangleAreaExact(a, point, c) + TriangleAreaExact(a, b, point);
+	return fabsl(area - sum) <= 1e-12L * std::max(area, sum);
+}
+
+//Bound of the rounding error of Vector2::TriangleArea, which sums its terms in double and rounds the area to float once
+static long double TriangleAreaError(const Exact<2>& a, const Exact<2>& b, const Exact<2>& c)
+{
+	const long double terms = fabsl(a.v[0] * (b.v[1] - c.v[1])) + fabsl(b.v[0] * (c.v[1] - a.v[1])) + fabsl(c.v[0] * (a.v[1] - b.v[1]));
+	return 4 * DBL_EPSILON * terms + FLT_EPSILON / 2 * TriangleAreaExact(a, b, c);
+}
+
+//Bound of the rounding error of Vector3::TriangleArea, a few ULP of the product of the edge lengths in float
+static long double TriangleAreaError(const Exact<3>& a, const Exact<3>& b, const Exact<3>& c)
+{
+	return 4 * FLT_EPSILON * Length(a - c) * Length(b - c);
+}
+
+//Contract of Vector2::PointTriangleIntersection and Vector3::PointTriangleIntersection: the three areas add up to the area of the triangle within FLT_EPSILON
+//Returns undecided when the float areas the function sums are rounded by more than the distance to that threshold, either answer is correct then
+template <int N>
+static long double PointTriangleExact(const Exact<N>& point, const Exact<N>& a, const Exact<N>& b, const Exact<N>& c)
+{
+	const long double area = TriangleAreaExact(a, b, c);
+	const long double sum = TriangleAreaExact(point, b, c) + TriangleAreaExact(a, point, c) + TriangleAreaExact(a, b, point);
+	const long double error = TriangleAreaError(a, b, c) + TriangleAreaError(point, b, c) + TriangleAreaError(a, point, c) + TriangleAreaError(a, b, point) + 2 * FLT_EPSILON * (area + sum);
+	const long double difference = fabsl(area - sum);
+	if (difference + error < FLT_EPSILON) return 1;
+	if (difference - error >= FLT_EPSILON) return 0;
+	return AccuracyHarness::undecided;
+}
+
+template <int N>
+static Exact<N> ClosestOnSegmentExact(const Exact<N>& point, const Exact<N>& a, const Exact<N>& b)
+{
+	const Exact<N> edge = b - a;
+	const long double length = Dot(edge, edge);
+	if (length == 0) return a;
+	return a + edge * ClampExact(Dot(point - a, edge) / length, 0, 1);
+}
+
+//Squared distance of two segments, the smallest of the four endpoint to segment distances and of the closest points of the lines when both are inside the segments
+//Closest points are not unique for parallel segments, so the distance is what is compared
+static long double SegmentSegmentExact(const Exact<3>& p0, const Exact<3>& p1, const Exact<3>& q0, const Exact<3>& q1)
+{
+	const auto sqrDistance = [](const Exact<3>& lhs, const Exact<3>& rhs) { const Exact<3> offset = lhs - rhs; return Dot(offset, offset); };
+	long double best = std::min({ sqrDistance(p0, ClosestOnSegmentExact(p0, q0, q1)), sqrDistance(p1, ClosestOnSegmentExact(p1, q0, q1)),
+		sqrDistance(q0, ClosestOnSegmentExact(q0, p0, p1)), sqrDistance(q1, ClosestOnSegmentExact(q1, p0, p1)) });
+
+	const Exact<3> d1 = p1 - p0, d2 = q1 - q0, r = p0 - q0;
+	const long double a = Dot(d1, d1), b = Dot(d1, d2), c = Dot(d1, r), e = Dot(d2, d2), f = Dot(d2, r);
+	const long double denominator = a * e - b * b;
+	if (denominator > 0)
+	{
+		const long double s = (b * f - c * e) / denominator, t = (a * f - b * c) / denominator;
+		if (s > 0 && s < 1 && t > 0 && t < 1) best = std::min(best, sqrDistance(p0 + d1 * s, q0 + d2 * t));
+	}
+	return best;
+}
+
+//Closest point on the triangle is the projection onto its plane when that is inside, otherwise the closest point of an edge
+static Exact<3> ClosestOnTriangleExact(const Exact<3>& point, const Exact<3>& a, const Exact<3>& b, const Exact<3>& c)
+{
+	const Exact<3> normal = Cross(b - a, c - a);
+	const long double normalLength = Dot(normal, normal);
+	if (normalLength > 0)
+	{
+		const Exact<3> projected = point - normal * (Dot(point - a, normal) / normalLength);
+		if (InsideExact(projected, a, b, c)) return projected;
+	}
+
+	Exact<3> best = ClosestOnSegmentExact(point, a, b);
+	for (const Exact<3>& candidate : { ClosestOnSegmentExact(point, b, c), ClosestOnSegmentExact(point, c, a) })
+	{
+		const Exact<3> bestOffset = best - point, candidateOffset = candidate - point;
+		if (Dot(candidateOffset, candidateOffset) < Dot(bestOffset, bestOffset)) best = candidate;
+	}
+	return best;
+}
+
+static Vector2 Load2(const float* inputs)
+{
+	return Vector2(inputs[0], inputs[1]);
+}
+
+static Vector3 Load3(const float* inputs)
+{
+	return Vector3(inputs[0], inputs[1], inputs[2]);
+}
+
+static Vector4 Load4(const float* inputs)
+{
+	return Vector4(inputs[0], inputs[1], inputs[2], inputs[3]);
+}
+
+static void Store(float* outputs, const Vector2& vector)
+{
+	outputs[0] = vector.x;
+	outputs[1] = vector.y;
+}
+
+static void Store(float* outputs, const Vector3& vector)
+{
+	outputs[0] = vector.x;
+	outputs[1] = vector.y;
+	outputs[2] = vector.z;
+}
+
+static void Store(float* outputs, const Vector4& vector)
+{
+	outputs[0] = vector.x;
+	outputs[1] = vector.y;
+	outputs[2] = vector.z;
+	outputs[3] = vector.w;
+}
+
+//Wraps a function of one sample into a kernel that loops over the samples
+template <typename Function, typename Reference>
+static AccuracyHarness::Kernel ScalarKernel(const char* name, const int inputs, const int outputs, Function function, Reference reference, const int flags = 0, const int triangle = -1, const int triangleDimensions = 3)
+{
+	AccuracyHarness::Kernel kernel;
+	kernel.name = name;
+	kernel.mode = "scalar";
+	kernel.inputs = inputs;
+	kernel.outputs = outputs;
+	kernel.flags = flags;
+	kernel.triangle = triangle;
+	kernel.triangleDimensions = triangleDimensions;
+	kernel.run = [function, inputs, outputs](float* out, const float* in, const size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+			function(out + i * outputs, in + i * inputs);
+	};
+	kernel.reference = reference;
+	return kernel;
+}
+
+//Wraps a VectorBatch function into a kernel that runs on path, samples are transposed into one array per component with count floats each
+//Transposition is part of the measured time, like the copies of the scalar kernels
+template <typename Function, typename Reference>
+static AccuracyHarness::Kernel BatchKernel(const char* name, const VectorBatch::Path path, const int inputs, const int outputs, Function function, Reference reference)
+{
+	AccuracyHarness::Kernel kernel;
+	kernel.name = name;
+	kernel.mode = VectorBatch::PathName(path);
+	kernel.inputs = inputs;
+	kernel.outputs = outputs;
+	kernel.run = [function, path, inputs, outputs](float* out, const float* in, const size_t count)
+	{
+		thread_local std::vector<float> components;
+		thread_local std::vector<float> results;
+		components.resize(count * inputs);
+		results.resize(count * outputs);
+		for (size_t i = 0; i < count; i++)
+			for (int k = 0; k < inputs; k++) components[k * count + i] = in[i * inputs + k];
+
+		const VectorBatch::Path previous = VectorBatch::ActivePath();
+		VectorBatch::SetPath(path);
+		function(results.data(), components.data(), count);
+		VectorBatch::SetPath(previous);
+
+		for (size_t i = 0; i < count; i++)
+			for (int k = 0; k < outputs; k++) out[i * outputs + k] = results[k * count + i];
+	};
+	kernel.reference = reference;
+	return kernel;
+}
+
+//Sets Kernel::scalePower, so kernels can be registered in one expression
+static AccuracyHarness::Kernel Scaled(AccuracyHarness::Kernel kernel, const int scalePower)
+{
+	kernel.scalePower = scalePower;
+	return kernel;
+}
+
+//Largest finite input magnitude to the power of the kernel, 0 when no input is finite and nonzero
+static long double InputScale(const AccuracyHarness::Kernel& kernel, const float* inputs)
+{
+	long double largest = 0;
+	for (int i = 0; i < kernel.inputs; i++)
+		if (std::isfinite(inputs[i])) largest = std::max(largest, fabsl(inputs[i]));
+	if (largest == 0) return 0;
+
+	long double scale = 1;
+	for (int i = 0; i < kernel.scalePower; i++) scale *= largest;
+	return scale;
+}
+
+const char* AccuracyHarness::Report::Rating() const
+{
+	static const char* const ratings[] = { "exact", "faithful", "accurate", "approximate", "unsafe" };
+	const auto tier = [](const double ulp) { return ulp <= 0.5 ? 0 : ulp <= 1 ? 1 : ulp <= 16 ? 2 : ulp <= 65536 ? 3 : 4; };
+
+	//Mismatches are wrong flags, NaN or infinity, no error percentile makes up for them
+	if (mismatches > 0) return ratings[4];
+	//Rating is at most one tier better than the worst error
+	return ratings[std::max(tier(p99Ulp), tier(maxUlp) - 1)];
+}
+
+void AccuracyHarness::Register(const Kernel& kernel)
+{
+	kernels.push_back(kernel);
+}
+
+const std::vector<AccuracyHarness::Kernel>& AccuracyHarness::Kernels() const
+{
+	return kernels;
+}
+
+double AccuracyHarness::UlpError(const float value, const long double reference, const long double scale)
+{
+	if (std::isnan(value) || std::isnan(reference)) return std::isnan(value) && std::isnan(reference) ? 0 : std::numeric_limits<double>::infinity();
+
+	const float rounded = static_cast<float>(reference);
+	if (std::isinf(value) || std::isinf(rounded)) return value == rounded ? 0 : std::numeric_limits<double>::infinity();
+
+	//Spacing of floats at the reference, the largest float uses the spacing below it
+	const float magnitude = std::fabs(rounded);
+	long double spacing = magnitude == FLT_MAX ? magnitude - std::nextafter(magnitude, 0.0f) : std::nextafter(magnitude, std::numeric_limits<float>::infinity()) - magnitude;
+
+	//Floats in [2^(e - 1), 2^e) are 2^(e - 24) apart, scale may be beyond the float range
+	if (scale > 0 && std::isfinite(scale))
+	{
+		int exponent;
+		frexpl(scale, &exponent);
+		spacing = std::max(spacing, ldexpl(1, exponent - FLT_MANT_DIG));
+	}
+	return static_cast<double>(fabsl(static_cast<long double>(value) - reference) / spacing);
+}
+
+void AccuracyHarness::RegisterDefaults()
+{
+	using E2 = Exact<2>;
+	using E3 = Exact<3>;
+	using E4 = Exact<4>;
+	const long double degrees = 180.0L / 3.141592653589793238462643383279502884L;
+
+	//Vector2
+	Register(Scaled(ScalarKernel("Vector2::Angle", 4, 1,
+		[](float* out, const float* in) { out[0] = Vector2::Angle(Load2(in), Load2(in + 2)); },
+		[degrees](long double* out, const float* in) { const E2 a = LoadExact<2>(in), b = LoadExact<2>(in + 2); out[0] = acosl(ClampExact(Dot(a, b) / (Length(a) * Length(b)), -1, 1)) * degrees; }), 0));
+	Register(Scaled(ScalarKernel("Vector2::Dot", 4, 1,
+		[](float* out, const float* in) { out[0] = Vector2::Dot(Load2(in), Load2(in + 2)); },
+		[](long double* out, const float* in) { out[0] = Dot(LoadExact<2>(in), LoadExact<2>(in + 2)); }), 2));
+	Register(ScalarKernel("Vector2::Distance", 4, 1,
+		[](float* out, const float* in) { out[0] = Vector2::Distance(Load2(in), Load2(in + 2)); },
+		[](long double* out, const float* in) { out[0] = Length(LoadExact<2>(in) - LoadExact<2>(in + 2)); }));
+	Register(ScalarKernel("Vector2::Lerp", 5, 2,
+		[](float* out, const float* in) { Store(out, Vector2::Lerp(Load2(in), Load2(in + 2), in[4])); },
+		[](long double* out, const float* in) { const long double t = ClampExact(in[4], 0, 1); StoreExact(out, LoadExact<2>(in + 2) * t + LoadExact<2>(in) * (1 - t)); }));
+	Register(ScalarKernel("Vector2::LerpNoClamp", 5, 2,
+		[](float* out, const float* in) { Store(out, Vector2::LerpNoClamp(Load2(in), Load2(in + 2), in[4])); },
+		[](long double* out, const float* in) { StoreExact(out, LoadExact<2>(in + 2) * in[4] + LoadExact<2>(in) * (1 - static_cast<long double>(in[4]))); }));
+	Register(ScalarKernel("Vector2::MoveTowards", 5, 2,
+		[](float* out, const float* in) { Store(out, Vector2::MoveTowards(Load2(in), Load2(in + 2), in[4])); },
+		[](long double* out, const float* in)
+		{
+			const E2 from = LoadExact<2>(in), to = LoadExact<2>(in + 2), direction = to - from;
+			const long double magnitude = Length(direction);
+			StoreExact(out, magnitude <= in[4] || in[4] < FLT_EPSILON ? to : from + direction * (in[4] / magnitude));
+		}));
+	Register(ScalarKernel("Vector2::Perpendicular", 2, 2,
+		[](float* out, const float* in) { Store(out, Vector2::Perpendicular(Load2(in))); },
+		[](long double* out, const float* in) { out[0] = -static_cast<long double>(in[1]); out[1] = in[0]; }));
+	Register(ScalarKernel("Vector2::Reflect", 4, 2,
+		[](float* out, const float* in) { Store(out, Vector2::Reflect(Load2(in), Load2(in + 2))); },
+		[](long double* out, const float* in) { const E2 v = LoadExact<2>(in), n = LoadExact<2>(in + 2); StoreExact(out, v - n * (2 * Dot(n, v))); }));
+	Register(Scaled(ScalarKernel("Vector2::TriangleArea", 6, 1,
+		[](float* out, const float* in) { out[0] = Vector2::TriangleArea(Load2(in), Load2(in + 2), Load2(in + 4)); },
+		[](long double* out, const float* in) { out[0] = TriangleAreaExact(LoadExact<2>(in), LoadExact<2>(in + 2), LoadExact<2>(in + 4)); }, 0, 0, 2), 2));
+	Register(ScalarKernel("Vector2::PointTriangleIntersection", 8, 1,
+		[](float* out, const float* in) { out[0] = Vector2::PointTriangleIntersection(Load2(in), Load2(in + 2), Load2(in + 4), Load2(in + 6)) ? 1.0f : 0.0f; },
+		[](long double* out, const float* in) { out[0] = PointTriangleExact(LoadExact<2>(in), LoadExact<2>(in + 2), LoadExact<2>(in + 4), LoadExact<2>(in + 6)); }, 1, 2, 2));
+	Register(Scaled(ScalarKernel("Vector2::Normalize", 2, 2,
+		[](float* out, const float* in) { Store(out, Load2(in).Normalize()); },
+		[](long double* out, const float* in) { const E2 v = LoadExact<2>(in); StoreExact(out, v * (1 / Length(v))); }), 0));
+	Register(Scaled(ScalarKernel("Vector2::SqrMagnitude", 2, 1,
+		[](float* out, const float* in) { out[0] = Load2(in).SqrMagnitude(); },
+		[](long double* out, const float* in) { const E2 v = LoadExact<2>(in); out[0] = Dot(v, v); }), 2));
+	Register(ScalarKernel("Vector2::Magnitude", 2, 1,
+		[](float* out, const float* in) { out[0] = Load2(in).Magnitude(); },
+		[](long double* out, const float* in) { out[0] = Length(LoadExact<2>(in)); }));
+	Register(ScalarKernel("Vector2::operator==", 4, 1,
+		[](float* out, const float* in) { out[0] = Load2(in) == Load2(in + 2) ? 1.0f : 0.0f; },
+		[](long double* out, const float* in) { const E2 d = LoadExact<2>(in) - LoadExact<2>(in + 2); out[0] = Dot(d, d) < DBL_EPSILON ? 1 : 0; }, 1));
+
+	//Vector3
+	Register(Scaled(ScalarKernel("Vector3::Angle", 6, 1,
+		[](float* out, const float* in) { out[0] = Vector3::Angle(Load3(in), Load3(in + 3)); },
+		[degrees](long double* out, const float* in) { const E3 a = LoadExact<3>(in), b = LoadExact<3>(in + 3); out[0] = acosl(ClampExact(Dot(a, b) / (Length(a) * Length(b)), -1, 1)) * degrees; }), 0));
+	Register(Scaled(ScalarKernel("Vector3::Cross", 6, 3,
+		[](float* out, const float* in) { Store(out, Vector3::Cross(Load3(in), Load3(in + 3))); },
+		[](long double* out, const float* in) { StoreExact(out, Cross(LoadExact<3>(in), LoadExact<3>(in + 3))); }), 2));
+	Register(Scaled(ScalarKernel("Vector3::Dot", 6, 1,
+		[](float* out, const float* in) { out[0] = Vector3::Dot(Load3(in), Load3(in + 3)); },
+		[](long double* out, const float* in) { out[0] = Dot(LoadExact<3>(in), LoadExact<3>(in + 3)); }), 2));
+	Register(ScalarKernel("Vector3::Distance", 6, 1,
+		[](float* out, const float* in) { out[0] = Vector3::Distance(Load3(in), Load3(in + 3)); },
+		[](long double* out, const float* in) { out[0] = Length(LoadExact<3>(in) - LoadExact<3>(in + 3)); }));
+	Register(ScalarKernel("Vector3::Lerp", 7, 3,
+		[](float* out, const float* in) { Store(out, Vector3::Lerp(Load3(in), Load3(in + 3), in[6])); },
+		[](long double* out, const float* in) { const long double t = ClampExact(in[6], 0, 1); StoreExact(out, LoadExact<3>(in + 3) * t + LoadExact<3>(in) * (1 - t)); }));
+	Register(ScalarKernel("Vector3::LerpNoClamp", 7, 3,
+		[](float* out, const float* in) { Store(out, Vector3::LerpNoClamp(Load3(in), Load3(in + 3), in[6])); },
+		[](long double* out, const float* in) { StoreExact(out, LoadExact<3>(in + 3) * in[6] + LoadExact<3>(in) * (1 - static_cast<long double>(in[6]))); }));
+	Register(ScalarKernel("Vector3::MoveTowards", 7, 3,
+		[](float* out, const float* in) { Store(out, Vector3::MoveTowards(Load3(in), Load3(in + 3), in[6])); },
+		[](long double* out, const float* in)
+		{
+			const E3 from = LoadExact<3>(in), to = LoadExact<3>(in + 3), direction = to - from;
+			const long double magnitude = Length(direction);
+			StoreExact(out, magnitude <= in[6] || in[6] < FLT_EPSILON ? to : from + direction * (in[6] / magnitude));
+		}));
+	Register(ScalarKernel("Vector3::Project", 6, 3,
+		[](float* out, const float* in) { Store(out, Vector3::Project(Load3(in), Load3(in + 3))); },
+		[](long double* out, const float* in)
+		{
+			const E3 v = LoadExact<3>(in), n = LoadExact<3>(in + 3);
+			const long double magnitude = Dot(n, n);
+			StoreExact(out, magnitude < FLT_EPSILON ? n * 0 : n * (Dot(v, n) / magnitude));
+		}));
+	Register(ScalarKernel("Vector3::ProjectOnPlane", 6, 3,
+		[](float* out, const float* in) { Store(out, Vector3::ProjectOnPlane(Load3(in), Load3(in + 3))); },
+		[](long double* out, const float* in)
+		{
+			const E3 v = LoadExact<3>(in), n = LoadExact<3>(in + 3);
+			const long double magnitude = Dot(n, n);
+			StoreExact(out, magnitude < FLT_EPSILON ? v : v - n * (Dot(v, n) / magnitude));
+		}));
+	Register(ScalarKernel("Vector3::Reflect", 6, 3,
+		[](float* out, const float* in) { Store(out, Vector3::Reflect(Load3(in), Load3(in + 3))); },
+		[](long double* out, const float* in) { const E3 v = LoadExact<3>(in), n = LoadExact<3>(in + 3); StoreExact(out, v - n * (2 * Dot(n, v))); }));
+	Register(Scaled(ScalarKernel("Vector3::TriangleArea", 9, 1,
+		[](float* out, const float* in) { out[0] = Vector3::TriangleArea(Load3(in), Load3(in + 3), Load3(in + 6)); },
+		[](long double* out, const float* in) { out[0] = TriangleAreaExact(LoadExact<3>(in), LoadExact<3>(in + 3), LoadExact<3>(in + 6)); }, 0, 0), 2));
+	Register(ScalarKernel("Vector3::PointTriangleIntersection", 12, 1,
+		[](float* out, const float* in) { out[0] = Vector3::PointTriangleIntersection(Load3(in), Load3(in + 3), Load3(in + 6), Load3(in + 9)) ? 1.0f : 0.0f; },
+		[](long double* out, const float* in) { out[0] = PointTriangleExact(LoadExact<3>(in), LoadExact<3>(in + 3), LoadExact<3>(in + 6), LoadExact<3>(in + 9)); }, 1, 3));
+	Register(ScalarKernel("Vector3::LinePlaneIntersection", 12, 4,
+		[](float* out, const float* in)
+		{
+			Vector3 intersection;
+			out[0] = Vector3::LinePlaneIntersection(intersection, Load3(in).Normalize(), Load3(in + 3), Load3(in + 6), Load3(in + 9)) ? 1.0f : 0.0f;
+			Store(out + 1, intersection);
+		},
+		[](long double* out, const float* in)
+		{
+			//Direction is normalized in float by the caller, the reference starts from that same float vector
+			const Vector3 normalized = Load3(in).Normalize();
+			const E3 direction = { { normalized.x, normalized.y, normalized.z } };
+			const E3 origin = LoadExact<3>(in + 3), normal = LoadExact<3>(in + 6), plane = LoadExact<3>(in + 9);
+			const long double d = Dot(normal, direction);
+			const long double x = Dot(normal, plane - origin) / d;
+			out[0] = fabsl(d) < FLT_EPSILON || x < 0 ? 0 : 1;
+			StoreExact(out + 1, origin + direction * x);
+		}, 1));
+	Register(ScalarKernel("Vector3::LineTriangleIntersection", 15, 4,
+		[](float* out, const float* in)
+		{
+			Vector3 intersection;
+			out[0] = Vector3::LineTriangleIntersection(intersection, Load3(in).Normalize(), Load3(in + 3), Load3(in + 6), Load3(in + 9), Load3(in + 12)) ? 1.0f : 0.0f;
+			Store(out + 1, intersection);
+		},
+		[](long double* out, const float* in)
+		{
+			const Vector3 normalized = Load3(in).Normalize();
+			const E3 direction = { { normalized.x, normalized.y, normalized.z } };
+			const E3 origin = LoadExact<3>(in + 3), a = LoadExact<3>(in + 6), b = LoadExact<3>(in + 9), c = LoadExact<3>(in + 12);
+			const E3 edge1 = b - a, edge2 = c - a, normal = Cross(direction, edge2), s = origin - a, q = Cross(s, edge1);
+			const long double d = Dot(edge1, normal);
+			const long double u = Dot(s, normal) / d, v = Dot(direction, q) / d, t = Dot(edge2, q) / d;
+			out[0] = fabsl(d) < FLT_EPSILON || u < 0 || u > 1 || v < 0 || u + v > 1 || t <= FLT_EPSILON ? 0 : 1;
+			StoreExact(out + 1, origin + direction * t);
+		}, 1, 6));
+	Register(Scaled(ScalarKernel("Vector3::Normalize", 3, 3,
+		[](float* out, const float* in) { Store(out, Load3(in).Normalize()); },
+		[](long double* out, const float* in) { const E3 v = LoadExact<3>(in); StoreExact(out, v * (1 / Length(v))); }), 0));
+	Register(Scaled(ScalarKernel("Vector3::SqrMagnitude", 3, 1,
+		[](float* out, const float* in) { out[0] = Load3(in).SqrMagnitude(); },
+		[](long double* out, const float* in) { const E3 v = LoadExact<3>(in); out[0] = Dot(v, v); }), 2));
+	Register(ScalarKernel("Vector3::Magnitude", 3, 1,
+		[](float* out, const float* in) { out[0] = Load3(in).Magnitude(); },
+		[](long double* out, const float* in) { out[0] = Length(LoadExact<3>(in)); }));
+	Register(ScalarKernel("Vector3::operator==", 6, 1,
+		[](float* out, const float* in) { out[0] = Load3(in) == Load3(in + 3) ? 1.0f : 0.0f; },
+		[](long double* out, const float* in) { const E3 d = LoadExact<3>(in) - LoadExact<3>(in + 3); out[0] = Dot(d, d) < DBL_EPSILON ? 1 : 0; }, 1));
+
+	//Vector4
+	Register(Scaled(ScalarKernel("Vector4::Dot", 8, 1,
+		[](float* out, const float* in) { out[0] = Vector4::Dot(Load4(in), Load4(in + 4)); },
+		[](long double* out, const float* in) { out[0] = Dot(LoadExact<4>(in), LoadExact<4>(in + 4)); }), 2));
+	Register(ScalarKernel("Vector4::Distance", 8, 1,
+		[](float* out, const float* in) { out[0] = Vector4::Distance(Load4(in), Load4(in + 4)); },
+		[](long double* out, const float* in) { out[0] = Length(LoadExact<4>(in) - LoadExact<4>(in + 4)); }));
+	Register(ScalarKernel("Vector4::Lerp", 9, 4,
+		[](float* out, const float* in) { Store(out, Vector4::Lerp(Load4(in), Load4(in + 4), in[8])); },
+		[](long double* out, const float* in) { const long double t = ClampExact(in[8], 0, 1); StoreExact(out, LoadExact<4>(in + 4) * t + LoadExact<4>(in) * (1 - t)); }));
+	Register(ScalarKernel("Vector4::LerpNoClamp", 9, 4,
+		[](float* out, const float* in) { Store(out, Vector4::LerpNoClamp(Load4(in), Load4(in + 4), in[8])); },
+		[](long double* out, const float* in) { StoreExact(out, LoadExact<4>(in + 4) * in[8] + LoadExact<4>(in) * (1 - static_cast<long double>(in[8]))); }));
+	Register(ScalarKernel("Vector4::Project", 8, 4,
+		[](float* out, const float* in) { Store(out, Vector4::Project(Load4(in), Load4(in + 4))); },
+		[](long double* out, const float* in) { const E4 v = LoadExact<4>(in), n = LoadExact<4>(in + 4); StoreExact(out, n * (Dot(v, n) / Dot(n, n))); }));
+	Register(Scaled(ScalarKernel("Vector4::Normalize", 4, 4,
+		[](float* out, const float* in) { Store(out, Load4(in).Normalize()); },
+		[](long double* out, const float* in) { const E4 v = LoadExact<4>(in); StoreExact(out, v * (1 / Length(v))); }), 0));
+	Register(Scaled(ScalarKernel("Vector4::SqrMagnitude", 4, 1,
+		[](float* out, const float* in) { out[0] = Load4(in).SqrMagnitude(); },
+		[](long double* out, const float* in) { const E4 v = LoadExact<4>(in); out[0] = Dot(v, v); }), 2));
+	Register(ScalarKernel("Vector4::Magnitude", 4, 1,
+		[](float* out, const float* in) { out[0] = Load4(in).Magnitude(); },
+		[](long double* out, const float* in) { out[0] = Length(LoadExact<4>(in)); }));
+	Register(ScalarKernel("Vector4::operator==", 8, 1,
+		[](float* out, const float* in) { out[0] = Load4(in) == Load4(in + 4) ? 1.0f : 0.0f; },
+		[](long double* out, const float* in) { const E4 d = LoadExact<4>(in) - LoadExact<4>(in + 4); out[0] = Dot(d, d) < DBL_EPSILON ? 1 : 0; }, 1));
+
+	//Closest point queries, scalar and batch. A batch sample is four points against one shape so that every sample runs the SSE path
+	Register(ScalarKernel("ClosestPoint::PointSegment", 9, 3,
+		[](float* out, const float* in) { Vector3 closest; ClosestPoint::PointSegment(closest, Load3(in), Load3(in + 3), Load3(in + 6)); Store(out, closest); },
+		[](long double* out, const float* in) { StoreExact(out, ClosestOnSegmentExact(LoadExact<3>(in), LoadExact<3>(in + 3), LoadExact<3>(in + 6))); }));
+	Register(ScalarKernel("ClosestPoint::PointTriangle", 12, 3,
+		[](float* out, const float* in) { Vector3 closest; ClosestPoint::PointTriangle(closest, Load3(in), Load3(in + 3), Load3(in + 6), Load3(in + 9)); Store(out, closest); },
+		[](long double* out, const float* in) { StoreExact(out, ClosestOnTriangleExact(LoadExact<3>(in), LoadExact<3>(in + 3), LoadExact<3>(in + 6), LoadExact<3>(in + 9))); }, 0, 3));
+
+	Register(Scaled(ScalarKernel("ClosestPoint::SegmentSegment", 12, 1,
+		[](float* out, const float* in) { Vector3 closestP, closestQ; out[0] = ClosestPoint::SegmentSegment(closestP, closestQ, Load3(in), Load3(in + 3), Load3(in + 6), Load3(in + 9)); },
+		[](long double* out, const float* in) { out[0] = SegmentSegmentExact(LoadExact<3>(in), LoadExact<3>(in + 3), LoadExact<3>(in + 6), LoadExact<3>(in + 9)); }), 2));
+	//Bounds are given as a corner and an extent whose absolute value is used, so that min is never above max
+	Register(ScalarKernel("ClosestPoint::PointBounds", 9, 3,
+		[](float* out, const float* in)
+		{
+			Vector3 closest;
+			const Vector3 min = Load3(in + 3);
+			ClosestPoint::PointBounds(closest, Load3(in), Bounds(min, min + Vector3(std::fabs(in[6]), std::fabs(in[7]), std::fabs(in[8]))));
+			Store(out, closest);
+		},
+		[](long double* out, const float* in)
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				const float min = in[3 + axis];
+				out[axis] = ClampExact(in[axis], min, min + std::fabs(in[6 + axis]));
+			}
+		}));
+
+	Kernel segmentBatch = ScalarKernel("ClosestPoint::PointSegment", 18, 12,
+		[](float* out, const float* in)
+		{
+			Vector3 points[4], closest[4];
+			float sqrDistances[4];
+			for (int i = 0; i < 4; i++) points[i] = Load3(in + i * 3);
+			ClosestPoint::PointSegment(closest, sqrDistances, points, 4, Load3(in + 12), Load3(in + 15));
+			for (int i = 0; i < 4; i++) Store(out + i * 3, closest[i]);
+		},
+		[](long double* out, const float* in)
+		{
+			for (int i = 0; i < 4; i++) StoreExact(out + i * 3, ClosestOnSegmentExact(LoadExact<3>(in + i * 3), LoadExact<3>(in + 12), LoadExact<3>(in + 15)));
+		});
+	segmentBatch.mode = "batch";
+	Register(segmentBatch);
+
+	Kernel triangleBatch = ScalarKernel("ClosestPoint::PointTriangle", 21, 12,
+		[](float* out, const float* in)
+		{
+			Vector3 points[4], closest[4];
+			float sqrDistances[4];
+			for (int i = 0; i < 4; i++) points[i] = Load3(in + i * 3);
+			ClosestPoint::PointTriangle(closest, sqrDistances, points, 4, Load3(in + 12), Load3(in + 15), Load3(in + 18));
+			for (int i = 0; i < 4; i++) Store(out + i * 3, closest[i]);
+		},
+		[](long double* out, const float* in)
+		{
+			for (int i = 0; i < 4; i++) StoreExact(out + i * 3, ClosestOnTriangleExact(LoadExact<3>(in + i * 3), LoadExact<3>(in + 12), LoadExact<3>(in + 15), LoadExact<3>(in + 18)));
+		}, 0, 12);
+	triangleBatch.mode = "batch";
+	Register(triangleBatch);
+
+	//Batch of four points against bounds given like the scalar kernel
+	Kernel boundsBatch = ScalarKernel("ClosestPoint::PointBounds", 18, 12,
+		[](float* out, const float* in)
+		{
+			Vector3 points[4], closest[4];
+			float sqrDistances[4];
+			for (int i = 0; i < 4; i++) points[i] = Load3(in + i * 3);
+			const Vector3 min = Load3(in + 12);
+			const Bounds bounds(min, min + Vector3(std::fabs(in[15]), std::fabs(in[16]), std::fabs(in[17])));
+			ClosestPoint::PointBounds(closest, sqrDistances, points, 4, bounds);
+			for (int i = 0; i < 4; i++) Store(out + i * 3, closest[i]);
+		},
+		[](long double* out, const float* in)
+		{
+			for (int i = 0; i < 4; i++)
+				for (int axis = 0; axis < 3; axis++)
+				{
+					//Max corner is rounded to float like the bounds under test
+					const float min = in[12 + axis];
+					out[i * 3 + axis] = ClampExact(in[i * 3 + axis], min, min + std::fabs(in[15 + axis]));
+				}
+		});
+	boundsBatch.mode = "batch";
+	Register(boundsBatch);
+
+	//Four segments from consecutive point pairs against one segment
+	Kernel segmentSegmentBatch = ScalarKernel("ClosestPoint::SegmentSegment", 30, 4,
+		[](float* out, const float* in)
+		{
+			Vector3 points[8], closestP[4], closestQ[4];
+			for (int i = 0; i < 8; i++) points[i] = Load3(in + i * 3);
+			ClosestPoint::SegmentSegment(closestP, closestQ, out, points, 4, Load3(in + 24), Load3(in + 27));
+		},
+		[](long double* out, const float* in)
+		{
+			for (int i = 0; i < 4; i++) out[i] = SegmentSegmentExact(LoadExact<3>(in + i * 6), LoadExact<3>(in + i * 6 + 3), LoadExact<3>(in + 24), LoadExact<3>(in + 27));
+		});
+	segmentSegmentBatch.mode = "batch";
+	segmentSegmentBatch.scalePower = 2;
+	Register(segmentSegmentBatch);
+
+	Kernel horner = ScalarKernel("SplineKernels::Horner", 8, 4,
+		[](float* out, const float* in) { SplineKernels::Horner(in, 1, in + 4, 4, out); },
+		[](long double* out, const float* in)
+		{
+			for (int i = 0; i < 4; i++)
+			{
+				const long double t = in[4 + i];
+				out[i] = ((static_cast<long double>(in[3]) * t + in[2]) * t + in[1]) * t + in[0];
+			}
+		});
+	horner.mode = "batch";
+	Register(horner);
+
+	//SoA batches of VectorBatch on every path the processor supports, with the references of the scalar functions they replace
+	for (int index = 0; index <= static_cast<int>(VectorBatch::SupportedPath()); index++)
+	{
+		const VectorBatch::Path path = static_cast<VectorBatch::Path>(index);
+		Register(Scaled(BatchKernel("VectorBatch::Angle(Vector2)", path, 4, 1,
+			[](float* out, const float* in, const size_t count) { VectorBatch::Angle(out, { in, in + count }, { in + 2 * count, in + 3 * count }, count); },
+			[degrees](long double* out, const float* in) { const E2 a = LoadExact<2>(in), b = LoadExact<2>(in + 2); out[0] = acosl(ClampExact(Dot(a, b) / (Length(a) * Length(b)), -1, 1)) * degrees; }), 0));
+		Register(Scaled(BatchKernel("VectorBatch::Angle(Vector3)", path, 6, 1,
+			[](float* out, const float* in, const size_t count) { VectorBatch::Angle(out, { in, in + count, in + 2 * count }, { in + 3 * count, in + 4 * count, in + 5 * count }, count); },
+			[degrees](long double* out, const float* in) { const E3 a = LoadExact<3>(in), b = LoadExact<3>(in + 3); out[0] = acosl(ClampExact(Dot(a, b) / (Length(a) * Length(b)), -1, 1)) * degrees; }), 0));
+		Register(BatchKernel("VectorBatch::Reflect(Vector2)", path, 4, 2,
+			[](float* out, const float* in, const size_t count) { VectorBatch::Reflect({ out, out + count }, { in, in + count }, { in + 2 * count, in + 3 * count }, count); },
+			[](long double* out, const float* in) { const E2 v = LoadExact<2>(in), n = LoadExact<2>(in + 2); StoreExact(out, v - n * (2 * Dot(n, v))); }));
+		Register(BatchKernel("VectorBatch::Reflect(Vector3)", path, 6, 3,
+			[](float* out, const float* in, const size_t count) { VectorBatch::Reflect({ out, out + count, out + 2 * count }, { in, in + count, in + 2 * count }, { in + 3 * count, in + 4 * count, in + 5 * count }, count); },
+			[](long double* out, const float* in) { const E3 v = LoadExact<3>(in), n = LoadExact<3>(in + 3); StoreExact(out, v - n * (2 * Dot(n, v))); }));
+		Register(BatchKernel("VectorBatch::Project", path, 6, 3,
+			[](float* out, const float* in, const size_t count) { VectorBatch::Project({ out, out + count, out + 2 * count }, { in, in + count, in + 2 * count }, { in + 3 * count, in + 4 * count, in + 5 * count }, count); },
+			[](long double* out, const float* in)
+			{
+				const E3 v = LoadExact<3>(in), n = LoadExact<3>(in + 3);
+				const long double magnitude = Dot(n, n);
+				StoreExact(out, magnitude < FLT_EPSILON ? n * 0 : n * (Dot(v, n) / magnitude));
+			}));
+		Register(BatchKernel("VectorBatch::ProjectOnPlane", path, 6, 3,
+			[](float* out, const float* in, const size_t count) { VectorBatch::ProjectOnPlane({ out, out + count, out + 2 * count }, { in, in + count, in + 2 * count }, { in + 3 * count, in + 4 * count, in + 5 * count }, count); },
+			[](long double* out, const float* in)
+			{
+				const E3 v = LoadExact<3>(in), n = LoadExact<3>(in + 3);
+				const long double magnitude = Dot(n, n);
+				StoreExact(out, magnitude < FLT_EPSILON ? v : v - n * (Dot(v, n) / magnitude));
+			}));
+	}
+}
+
+//Random input in [-10, 10]
+static float RandomInput(std::mt19937& random)
+{
+	return std::uniform_real_distribution<float>(-10, 10)(random);
+}
+
+//Input from one of the cases fast paths tend to get wrong
+static float AdversarialInput(std::mt19937& random)
+{
+	std::uniform_real_distribution<float> unit(0, 1);
+	const float sign = unit(random) < 0.5f ? -1.0f : 1.0f;
+	const float kind = unit(random);
+
+	if (kind < 0.3f) return RandomInput(random);
+	if (kind < 0.4f) return sign * FLT_MIN * unit(random);
+	if (kind < 0.45f) return sign * std::numeric_limits<float>::infinity();
+	if (kind < 0.55f) return sign * std::pow(10.0f, std::uniform_real_distribution<float>(18, 38.5f)(random));
+	if (kind < 0.65f) return sign * std::pow(10.0f, std::uniform_real_distribution<float>(-37, -18)(random));
+	if (kind < 0.75f) return sign * 0.0f;
+	return sign * std::pow(10.0f, std::uniform_real_distribution<float>(-20, 20)(random));
+}
+
+//Replaces a triangle with a degenerate one: two equal vertices, three collinear vertices, a single point or a needle
+static void DegenerateTriangle(float* triangle, const int dimensions, std::mt19937& random)
+{
+	float* a = triangle;
+	float* b = triangle + dimensions;
+	float* c = triangle + dimensions * 2;
+	for (int i = 0; i < dimensions; i++)
+	{
+		a[i] = RandomInput(random);
+		b[i] = RandomInput(random);
+	}
+
+	const int kind = std::uniform_int_distribution<int>(0, 3)(random);
+	const float t = std::uniform_real_distribution<float>(-1, 2)(random);
+	for (int i = 0; i < dimensions; i++)
+	{
+		if (kind == 0) c[i] = b[i];
+		else if (kind == 1) c[i] = a[i] + (b[i] - a[i]) * t;
+		else if (kind == 2) b[i] = c[i] = a[i];
+		else
+		{
+			b[i] = a[i] + (b[i] - a[i]) * 1e-6f;
+			c[i] = RandomInput(random);
+		}
+	}
+}
+
+std::vector<AccuracyHarness::Report> AccuracyHarness::Run(const size_t samples, const uint32_t seed) const
+{
+	std::vector<Report> reports;
+	for (const Kernel& kernel : kernels)
+	{
+		double randomNanoseconds = 0;
+		for (int adversarial = 0; adversarial < 2; adversarial++)
+		{
+			std::mt19937 random(seed);
+			std::vector<float> inputs(samples * kernel.inputs);
+			for (size_t sample = 0; sample < samples; sample++)
+			{
+				float* in = inputs.data() + sample * kernel.inputs;
+				for (int i = 0; i < kernel.inputs; i++)
+					in[i] = adversarial ? AdversarialInput(random) : RandomInput(random);
+				if (adversarial && kernel.triangle >= 0 && random() % 2 == 0) DegenerateTriangle(in + kernel.triangle, kernel.triangleDimensions, random);
+			}
+
+			std::vector<float> outputs(samples * kernel.outputs, 0.0f);
+			kernel.run(outputs.data(), inputs.data(), samples);
+
+			//Throughput is the best of a few runs on random inputs, denormals on the adversarial set would only measure the hardware penalty for them
+			if (!adversarial)
+			{
+				std::vector<float> scratch(outputs.size());
+				randomNanoseconds = std::numeric_limits<double>::infinity();
+				for (int repeat = 0; repeat < 3; repeat++)
+				{
+					const auto start = std::chrono::steady_clock::now();
+					kernel.run(scratch.data(), inputs.data(), samples);
+					const auto end = std::chrono::steady_clock::now();
+					randomNanoseconds = std::min(randomNanoseconds, std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(std::max<size_t>(1, samples)));
+				}
+			}
+
+			Report report;
+			report.name = kernel.name;
+			report.mode = kernel.mode;
+			report.inputs = adversarial ? "adversarial" : "random";
+			report.samples = samples;
+			report.nanosecondsPerSample = randomNanoseconds;
+
+			std::vector<double> errors;
+			errors.reserve(samples * kernel.outputs);
+			std::vector<long double> expected(kernel.outputs);
+			double sum = 0;
+			for (size_t sample = 0; sample < samples; sample++)
+			{
+				std::fill(expected.begin(), expected.end(), 0.0L);
+				kernel.reference(expected.data(), inputs.data() + sample * kernel.inputs);
+				const float* result = outputs.data() + sample * kernel.outputs;
+				const long double scale = InputScale(kernel, inputs.data() + sample * kernel.inputs);
+
+				bool flagged = true;
+				bool mismatch = false;
+				bool undecided = false;
+				for (int i = 0; i < kernel.flags; i++)
+				{
+					if (expected[i] == AccuracyHarness::undecided)
+					{
+						undecided = true;
+						flagged = false;
+						continue;
+					}
+					mismatch = mismatch || (result[i] != 0) != (expected[i] != 0);
+					flagged = flagged && expected[i] != 0;
+				}
+				if (undecided && !mismatch) report.undecided++;
+
+				for (int i = kernel.flags; i < kernel.outputs && flagged && !mismatch; i++)
+				{
+					const double error = UlpError(result[i], expected[i], scale);
+					if (std::isinf(error))
+					{
+						mismatch = true;
+						break;
+					}
+					errors.push_back(error);
+					sum += error;
+					report.maxUlp = std::max(report.maxUlp, error);
+				}
+
+				if (mismatch) report.mismatches++;
+			}
+
+			if (!errors.empty())
+			{
+				report.meanUlp = sum / static_cast<double>(errors.size());
+				const size_t percentile = errors.size() * 99 / 100;
+				std::nth_element(errors.begin(), errors.begin() + percentile, errors.end());
+				report.p99Ulp = errors[percentile];
+			}
+			reports.push_back(report);
+		}
+	}
+
+	return reports;
+}
+
+void AccuracyHarness::Print(std::ostream& stream, const std::vector<Report>& reports)
+{
+	const std::ios::fmtflags flags = stream.flags();
+	stream << std::left << std::setw(38) << "Function" << std::setw(8) << "Mode" << std::setw(13) << "Inputs" << std::right
+		<< std::setw(12) << "Max ULP" << std::setw(12) << "Mean ULP" << std::setw(12) << "P99 ULP" << std::setw(12) << "Mismatches" << std::setw(11) << "Undecided" << std::setw(10) << "ns" << "  Rating\n";
+
+	for (const Report& report : reports)
+	{
+		stream << std::left << std::setw(38) << report.name << std::setw(8) << report.mode << std::setw(13) << report.inputs << std::right
+			<< std::setprecision(3) << std::setw(12) << report.maxUlp << std::setw(12) << report.meanUlp << std::setw(12) << report.p99Ulp
+			<< std::setw(12) << report.mismatches << std::setw(11) << report.undecided << std::setw(10) << report.nanosecondsPerSample << "  " << report.Rating() << "\n";
+	}
+	stream.flags(flags);
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//Measures accuracy of float code paths against long double references, together with their throughput
+//Every kernel runs on uniformly random inputs and on adversarial inputs: denormals, infinities, huge and tiny magnitudes, signed zeros and degenerate triangles
+//Errors are in units in the last place (ULP) of the float nearest to the reference, so a correctly rounded result has at most 0.5
+class AccuracyHarness
+{
+public:
+	//Flag a reference sets when the sample is within the rounding error of the test under measurement, either answer counts as correct
+	static constexpr long double undecided = -1;
+
+	//Function under test and its reference, both take inputs as flat float arrays of fixed size per sample
+	struct Kernel
+	{
+		std::string name;
+		//Code path, e.g. scalar, SSE or AVX2, so that every path of one function gets its own rating
+		std::string mode;
+		int inputs = 0;
+		int outputs = 0;
+		//Leading outputs that are booleans, the other outputs are only compared when every flag is set in the reference
+		//Reference flags are 0, 1 or undecided
+		int flags = 0;
+		//First input of a triangle that adversarial samples may make degenerate, -1 if there is none
+		int triangle = -1;
+		int triangleDimensions = 3;
+		//Outputs scale like the largest input to this power, e.g. 2 for dot products and 0 for angles and unit vectors
+		//Errors are measured in ULP of at least that magnitude, so references that cancel to near zero are not measured against the spacing of denormals
+		int scalePower = 1;
+		//Runs count samples, sample i reads inputs [i * inputs, (i + 1) * inputs) and writes outputs [i * outputs, (i + 1) * outputs)
+		std::function<void(float* outputs, const float* inputs, size_t count)> run;
+		//Computes the outputs of one sample
+		std::function<void(long double* outputs, const float* inputs)> reference;
+	};
+
+	struct Report
+	{
+		std::string name;
+		std::string mode;
+		//random or adversarial
+		std::string inputs;
+		size_t samples = 0;
+		double maxUlp = 0;
+		double meanUlp = 0;
+		//99th percentile error, the rating is based on it so that a single catastrophic cancellation does not hide how a path behaves in general, but stays within one tier of maxUlp
+		double p99Ulp = 0;
+		//Samples whose flags differ from the reference, or whose results are finite where the reference is not or the other way around
+		size_t mismatches = 0;
+		//Samples with an undecided reference flag, they are neither mismatches nor compared
+		size_t undecided = 0;
+		//Time per sample, measured on random inputs
+		double nanosecondsPerSample = 0;
+
+		//exact (p99 up to 0.5 ULP), faithful (1), accurate (16), approximate (65536) or unsafe, at most one tier better than maxUlp gives and unsafe with any mismatch
+		[[nodiscard]]
+		const char* Rating() const;
+	};
+
+	void Register(const Kernel& kernel);
+
+	//Registers every public function of Vector2, Vector3 and Vector4, every query of ClosestPoint but PointMesh in scalar and batch form, SplineKernels and VectorBatch on every supported path
+	void RegisterDefaults();
+
+	//Runs every registered kernel, each one gives a random and an adversarial report
+	[[nodiscard]]
+	std::vector<Report> Run(size_t samples = 1 << 14, uint32_t seed = 1) const;
+
+	[[nodiscard]]
+	const std::vector<Kernel>& Kernels() const;
+
+	static void Print(std::ostream& stream, const std::vector<Report>& reports);
+
+	//Distance of value from reference in ULP of the float nearest to reference, or in ULP of a float of magnitude scale if that is larger
+	//Returns 0 when both are the same infinity or both are NaN, infinity when only one of them is finite
+	static double UlpError(float value, long double reference, long double scale = 0);
+
+private:
+	std::vector<Kernel> kernels;
+};
@@ -0,0 +1,524 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: http://www.viva64.com
+
+#include "BVH.h"
+#include <algorithm>
+#include <chrono>
+
+static const int binCount = 12;
+
+static Bounds TriangleBounds(const Vector3* vertices, const uint32_t triangle)
+{
+	return Bounds::FromTriangle(vertices[triangle * 3], vertices[triangle * 3 + 1], vertices[triangle * 3 + 2]);
+}
+
+//BVH
+void BVH::Build(const Vector3* vertices, const size_t triangleCount)
+{
+	nodes.clear();
+	triangles.resize(triangleCount);
+	leafOf.assign(triangleCount, invalid);
+	root = invalid;
+	if (triangleCount == 0) return;
+
+	std::vector<Bounds> triangleBounds(triangleCount);
+	std::vector<Vector3> centroids(triangleCount);
+	for (uint32_t i = 0; i < triangleCount; i++)
+	{
+		triangles[i] = i;
+		triangleBounds[i] = TriangleBounds(vertices, i);
+		centroids[i] = triangleBounds[i].Center();
+	}
+
+	nodes.reserve(triangleCount * 2);
+	root = BuildRange(triangleBounds, centroids, 0, static_cast<uint32_t>(triangleCount), invalid);
+	dirty.assign(nodes.size(), 0);
+}
+
+uint32_t BVH::BuildRange(const std::vector<Bounds>& triangleBounds, const std::vector<Vector3>& centroids, const uint32_t begin, const uint32_t end, const uint32_t parent)
+{
+	const uint32_t index = static_cast<uint32_t>(nodes.size());
+	nodes.push_back(Node{ Bounds(), parent, begin, 0, end - begin });
+
+	Bounds bounds, centroidBounds;
+	for (uint32_t i = begin; i < end; i++)
+	{
+		bounds.Encapsulate(triangleBounds[triangles[i]]);
+		centroidBounds.Encapsulate(centroids[triangles[i]]);
+	}
+	nodes[index].bounds = bounds;
+
+	if (end - begin <= maxLeafSize)
+	{
+		for (uint32_t i = begin; i < end; i++)
+			leafOf[triangles[i]] = index;
+		return index;
+	}
+
+	int axis = 0;
+	const Vector3 extent = centroidBounds.max - centroidBounds.min;
+	if (extent.y > extent[axis]) axis = 1;
+	if (extent.z > extent[axis]) axis = 2;
+
+	uint32_t middle = begin;
+	if (extent[axis] > 0)
+	{
+		//Bin centroids and pick the split plane with the lowest surface area cost
+		Bounds binBounds[binCount];
+		uint32_t binTriangles[binCount] = {};
+		const float scale = binCount / extent[axis];
+		const auto binOf = [&](const uint32_t triangle)
+		{
+			const int bin = static_cast<int>((centroids[triangle][axis] - centroidBounds.min[axis]) * scale);
+			return std::min(bin, binCount - 1);
+		};
+
+		for (uint32_t i = begin; i < end; i++)
+		{
+			const int bin = binOf(triangles[i]);
+			binTriangles[bin]++;
+			binBounds[bin].Encapsulate(triangleBounds[triangles[i]]);
+		}
+
+		float rightArea[binCount];
+		uint32_t rightCount[binCount];
+		Bounds accumulated;
+		uint32_t count = 0;
+		for (int bin = binCount - 1; bin > 0; bin--)
+		{
+			accumulated.Encapsulate(binBounds[bin]);
+			count += binTriangles[bin];
+			rightArea[bin] = accumulated.SurfaceArea();
+			rightCount[bin] = count;
+		}
+
+		int split = 1;
+		float bestCost = std::numeric_limits<float>::infinity();
+		accumulated = Bounds();
+		count = 0;
+		for (int bin = 1; bin < binCount; bin++)
+		{
+			accumulated.Encapsulate(binBounds[bin - 1]);
+			count += binTriangles[bin - 1];
+			const float cost = accumulated.SurfaceArea() * count + rightArea[bin] * rightCount[bin];
+			if (count > 0 && rightCount[bin] > 0 && cost < bestCost)
+			{
+				bestCost = cost;
+				split = bin;
+			}
+		}
+
+		middle = static_cast<uint32_t>(std::partition(triangles.begin() + begin, triangles.begin() + end,
+			[&](const uint32_t triangle) { return binOf(triangle) < split; }) - triangles.begin());
+	}
+
+	//All centroids in one bin, split in the middle
+	if (middle == begin || middle == end)
+	{
+		middle = begin + (end - begin) / 2;
+		std::nth_element(triangles.begin() + begin, triangles.begin() + middle, triangles.begin() + end,
+			[&](const uint32_t lhs, const uint32_t rhs) { return centroids[lhs][axis] < centroids[rhs][axis]; });
+	}
+
+	const uint32_t first = BuildRange(triangleBounds, centroids, begin, middle, index);
+	const uint32_t second = BuildRange(triangleBounds, centroids, middle, end, index);
+	nodes[index].first = first;
+	nodes[index].second = second;
+	nodes[index].count = 0;
+
+	return index;
+}
+
+void BVH::Refit(const Vector3* vertices, const std::vector<uint32_t>& changed, const bool rotate)
+{
+	if (root == invalid) return;
+
+	//Mark paths from changed leaves to the root, walking stops at the first node that is already marked
+	for (const uint32_t triangle : changed)
+	{
+		uint32_t node = leafOf[triangle];
+		while (node != invalid && !dirty[node])
+		{
+			dirty[node] = 1;
+			node = nodes[node].parent;
+		}
+	}
+
+	RefitNode(vertices, root, rotate);
+}
+
+void BVH::RefitAll(const Vector3* vertices, const bool rotate)
+{
+	if (root == invalid) return;
+
+	std::fill(dirty.begin(), dirty.end(), static_cast<uint8_t>(1));
+	RefitNode(vertices, root, rotate);
+}
+
+void BVH::RefitNode(const Vector3* vertices, const uint32_t node, const bool rotate)
+{
+	if (!dirty[node]) return;
+	dirty[node] = 0;
+
+	Node& current = nodes[node];
+	if (current.count > 0)
+	{
+		Bounds bounds;
+		for (uint32_t i = current.first; i < current.first + current.count; i++)
+			bounds.Encapsulate(TriangleBounds(vertices, triangles[i]));
+		current.bounds = bounds;
+		return;
+	}
+
+	RefitNode(vertices, current.first, rotate);
+	RefitNode(vertices, current.second, rotate);
+	if (rotate) Rotate(node);
+	current.bounds = Bounds::Union(nodes[current.first].bounds, nodes[current.second].bounds);
+}
+
+void BVH::Rotate(const uint32_t node)
+{
+	//Swaps a child with a grandchild on the other side when that shrinks the other child, leaf set of node does not change
+	Node& current = nodes[node];
+	const uint32_t children[2] = { current.first, current.second };
+
+	float bestGain = 0;
+	int bestChild = -1;
+	int bestGrandchild = -1;
+
+	for (int child = 0; child < 2; child++)
+	{
+		const Node& other = nodes[children[1 - child]];
+		if (other.count > 0) continue;
+
+		const float area = other.bounds.SurfaceArea();
+		const Bounds& moved = nodes[children[child]].bounds;
+
+		//Grandchild g goes up, child takes its place next to the remaining grandchild
+		const float gainFirst = area - Bounds::Union(moved, nodes[other.second].bounds).SurfaceArea();
+		const float gainSecond = area - Bounds::Union(moved, nodes[other.first].bounds).SurfaceArea();
+		if (gainFirst > bestGain)
+		{
+			bestGain = gainFirst;
+			bestChild = child;
+			bestGrandchild = 0;
+		}
+		if (gainSecond > bestGain)
+		{
+			bestGain = gainSecond;
+			bestChild = child;
+			bestGrandchild = 1;
+		}
+	}
+
+	if (bestChild < 0) return;
+
+	const uint32_t child = children[bestChild];
+	const uint32_t otherIndex = children[1 - bestChild];
+	Node& other = nodes[otherIndex];
+	uint32_t& slot = bestGrandchild == 0 ? other.first : other.second;
+	const uint32_t grandchild = slot;
+
+	slot = child;
+	nodes[child].parent = otherIndex;
+	(bestChild == 0 ? current.first : current.second) = grandchild;
+	nodes[grandchild].parent = node;
+	other.bounds = Bounds::Union(nodes[other.first].bounds, nodes[other.second].bounds);
+}
+
+float BVH::Cost() const
+{
+	if (root == invalid) return 0;
+
+	const float rootArea = nodes[root].bounds.SurfaceArea();
+	if (rootArea <= 0) return 0;
+
+	float cost = 0;
+	for (const Node& node : nodes)
+		cost += node.bounds.SurfaceArea() * (node.count > 0 ? static_cast<float>(node.count) : 1.0f);
+
+	return cost / rootArea;
+}
+
+bool BVH::Raycast(RaycastHit& hit, const Vector3* vertices, const Vector3& direction, const Vector3& origin, const float maxDistance) const
+{
+	if (root == invalid) return false;
+
+	const Vector3 inverseDirection = Vector3(1, 1, 1) / direction;
+	float closest = maxDistance;
+	bool found = false;
+
+	thread_local std::vector<uint32_t> stack;
+	stack.clear();
+	stack.push_back(root);
+
+	while (!stack.empty())
+	{
+		const Node& node = nodes[stack.back()];
+		stack.pop_back();
+
+		float entry;
+		if (!node.bounds.RayIntersection(entry, origin, inverseDirection, closest)) continue;
+
+		if (node.count == 0)
+		{
+			//Visit the nearer child first so the far one is more likely to be culled by closest
+			float firstEntry, secondEntry;
+			const bool hitFirst = nodes[node.first].bounds.RayIntersection(firstEntry, origin, inverseDirection, closest);
+			const bool hitSecond = nodes[node.second].bounds.RayIntersection(secondEntry, origin, inverseDirection, closest);
+			if (hitFirst && hitSecond)
+			{
+				stack.push_back(firstEntry < secondEntry ? node.second : node.first);
+				stack.push_back(firstEntry < secondEntry ? node.first : node.second);
+			}
+			else if (hitFirst)
+			{
+				stack.push_back(node.first);
+			}
+			else if (hitSecond)
+			{
+				stack.push_back(node.second);
+			}
+			continue;
+		}
+
+		for (uint32_t i = node.first; i < node.first + node.count; i++)
+		{
+			const uint32_t triangle = triangles[i];
+			Vector3 point;
+			if (!Vector3::LineTriangleIntersection(point, direction, origin, vertices[triangle * 3], vertices[triangle * 3 + 1], vertices[triangle * 3 + 2])) continue;
+
+			const float distance = Vector3::Dot(point - origin, direction);
+			if (distance < closest)
+			{
+				closest = distance;
+				hit.point = point;
+				hit.distance = distance;
+				hit.triangle = triangle;
+				found = true;
+			}
+		}
+	}
+
+	return found;
+}
+
+void BVH::Overlap(const Bounds& bounds, std::vector<uint32_t>& result) const
+{
+	if (root == invalid) return;
+
+	thread_local std::vector<uint32_t> stack;
+	stack.clear();
+	stack.push_back(root);
+
+	while (!stack.empty())
+	{
+		const Node& node = nodes[stack.back()];
+		stack.pop_back();
+
+		if (!Bounds::Overlaps(node.bounds, bounds)) continue;
+
+		if (node.count == 0)
+		{
+			stack.push_back(node.first);
+			stack.push_back(node.second);
+			continue;
+		}
+
+		for (uint32_t i = node.first; i < node.first + node.count; i++)
+			result.push_back(triangles[i]);
+	}
+}
+
+uint32_t BVH::Root() const
+{
+	return root;
+}
+
+const std::vector<BVH::Node>& BVH::Nodes() const
+{
+	return nodes;
+}
+
+const std::vector<uint32_t>& BVH::Triangles() const
+{
+	return triangles;
+}
+
+//DynamicBVH
+bool DynamicBVH::Snapshot::Raycast(BVH::RaycastHit& hit, const Vector3& direction, const Vector3& origin, const float maxDistance) const
+{
+	return tree.Raycast(hit, vertices.data(), direction, origin, maxDistance);
+}
+
+DynamicBVH::DynamicBVH(const float rebuildThreshold) : rebuildThreshold(rebuildThreshold)
+{
+}
+
+DynamicBVH::~DynamicBVH()
+{
+	if (rebuild.valid()) rebuild.wait();
+}
+
+void DynamicBVH::Build(const Vector3* source, const size_t triangleCount)
+{
+	if (rebuild.valid()) rebuild.wait();
+	rebuild = std::future<std::unique_ptr<Snapshot>>();
+
+	vertices.assign(source, source + triangleCount * 3);
+	dirty.clear();
+	isDirty.assign(triangleCount, 0);
+
+	auto snapshot = std::make_unique<Snapshot>();
+	snapshot->vertices = vertices;
+	snapshot->tree.Build(vertices.data(), triangleCount);
+	builtCost = snapshot->tree.Cost();
+
+	changes.clear();
+	Publish(std::move(snapshot));
+	logStart = version;
+}
+
+void DynamicBVH::SetTriangle(const uint32_t triangle, const Vector3& a, const Vector3& b, const Vector3& c)
+{
+	vertices[triangle * 3] = a;
+	vertices[triangle * 3 + 1] = b;
+	vertices[triangle * 3 + 2] = c;
+
+	if (!isDirty[triangle])
+	{
+		isDirty[triangle] = 1;
+		dirty.push_back(triangle);
+	}
+}
+
+void DynamicBVH::Update()
+{
+	//Finished rebuild was built from older vertices, refit it to the current ones before publishing
+	if (rebuild.valid() && rebuild.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+	{
+		std::unique_ptr<Snapshot> rebuilt = rebuild.get();
+		builtCost = rebuilt->tree.Cost();
+		rebuilt->vertices = vertices;
+		rebuilt->tree.RefitAll(vertices.data());
+		rebuilds++;
+
+		for (const uint32_t triangle : dirty)
+			isDirty[triangle] = 0;
+		dirty.clear();
+
+		//Other buffers have the old topology, they are copied whole when reused
+		changes.clear();
+		Publish(std::move(rebuilt));
+		logStart = version;
+		return;
+	}
+
+	if (dirty.empty()) return;
+
+	//Replaying costs more than a copy once the log is longer than the triangle list, older buffers are copied whole then
+	const uint64_t next = version + 1;
+	if (changes.size() + dirty.size() > isDirty.size())
+	{
+		changes.clear();
+		logStart = next;
+	}
+	for (const uint32_t triangle : dirty)
+		changes.emplace_back(next, triangle);
+
+	Spare spare = TakeSpare();
+	Snapshot& snapshot = *spare.snapshot;
+	if (spare.version < logStart)
+	{
+		const std::shared_ptr<const Snapshot> current = Acquire();
+		snapshot.tree = current->tree;
+		snapshot.vertices = vertices;
+		snapshot.tree.Refit(snapshot.vertices.data(), dirty);
+	}
+	else
+	{
+		replay.clear();
+		const auto first = std::upper_bound(changes.begin(), changes.end(), spare.version,
+			[](const uint64_t value, const std::pair<uint64_t, uint32_t>& change) { return value < change.first; });
+		for (auto change = first; change != changes.end(); ++change)
+		{
+			const uint32_t triangle = change->second;
+			std::copy(vertices.begin() + triangle * 3, vertices.begin() + triangle * 3 + 3, snapshot.vertices.begin() + triangle * 3);
+			replay.push_back(triangle);
+		}
+		snapshot.tree.Refit(snapshot.vertices.data(), replay);
+	}
+
+	for (const uint32_t triangle : dirty)
+		isDirty[triangle] = 0;
+	dirty.clear();
+
+	const float cost = snapshot.tree.Cost();
+	Publish(std::move(spare.snapshot));
+
+	if (!rebuild.valid() && builtCost > 0 && cost > builtCost * rebuildThreshold)
+		StartRebuild();
+}
+
+void DynamicBVH::Publish(std::unique_ptr<Snapshot> snapshot)
+{
+	//Deleter runs when the last reader lets go, it hands the buffer back instead of freeing it
+	version++;
+	const std::shared_ptr<Recycler> target = recycler;
+	const uint64_t published = version;
+	std::shared_ptr<const Snapshot> shared(snapshot.release(), [target, published](const Snapshot* released)
+	{
+		const std::lock_guard<std::mutex> lock(target->mutex);
+		target->released.push_back(Spare{ std::unique_ptr<Snapshot>(const_cast<Snapshot*>(released)), published });
+	});
+	std::atomic_store(&front, std::move(shared));
+}
+
+DynamicBVH::Spare DynamicBVH::TakeSpare()
+{
+	//Newest released buffer has the fewest changes to replay
+	{
+		const std::lock_guard<std::mutex> lock(recycler->mutex);
+		std::vector<Spare>& released = recycler->released;
+		if (!released.empty())
+		{
+			const auto newest = std::max_element(released.begin(), released.end(),
+				[](const Spare& lhs, const Spare& rhs) { return lhs.version < rhs.version; });
+			std::swap(*newest, released.back());
+			Spare spare = std::move(released.back());
+			released.pop_back();
+			return spare;
+		}
+	}
+
+	//Every buffer is held by a reader, version 0 is older than any log so the new buffer is copied whole
+	return Spare{ std::make_unique<Snapshot>(), 0 };
+}
+
+void DynamicBVH::StartRebuild()
+{
+	auto snapshot = std::make_unique<Snapshot>();
+	snapshot->vertices = vertices;
+
+	rebuild = std::async(std::launch::async, [snapshot = std::move(snapshot)]() mutable
+	{
+		snapshot->tree.Build(snapshot->vertices.data(), snapshot->vertices.size() / 3);
+		return std::move(snapshot);
+	});
+}
+
+std::shared_ptr<const DynamicBVH::Snapshot> DynamicBVH::Acquire() const
+{
+	return std::atomic_load(&front);
+}
+
+bool DynamicBVH::Rebuilding() const
+{
+	return rebuild.valid() && rebuild.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+size_t DynamicBVH::RebuildCount() const
+{
+	return rebuilds;
+}
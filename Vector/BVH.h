@@ -0,0 +1,159 @@
+#pragma once
+#include "Bounds.h"
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//Bounding volume hierarchy over a triangle soup, every three consecutive vertices form a triangle
+//Tree does not own the vertices, they are passed to every call that needs them
+class BVH
+{
+public:
+	//Leaves have count > 0 and hold triangles [first, first + count) of Triangles(), internal nodes have count == 0 and two children
+	struct Node
+	{
+		Bounds bounds;
+		uint32_t parent;
+		uint32_t first;
+		uint32_t second;
+		uint32_t count;
+	};
+
+	struct RaycastHit
+	{
+		Vector3 point;
+		float distance;
+		uint32_t triangle;
+	};
+
+	static constexpr uint32_t maxLeafSize = 4;
+	static constexpr uint32_t invalid = 0xFFFFFFFF;
+
+	//Builds the tree with binned surface area heuristic
+	void Build(const Vector3* vertices, size_t triangleCount);
+
+	//Refits nodes above the given triangles bottom up, nodes on the refit path are rotated when it lowers their surface area
+	void Refit(const Vector3* vertices, const std::vector<uint32_t>& triangles, bool rotate = true);
+
+	//Refits every node
+	void RefitAll(const Vector3* vertices, bool rotate = true);
+
+	//Returns surface area heuristic cost of the tree relative to its root, lower is better
+	[[nodiscard]]
+	float Cost() const;
+
+	//Finds the closest triangle hit by a ray within maxDistance, returns true if there is intersection
+	//Caution: Make sure direction vector is normalized !
+	bool Raycast(RaycastHit& hit, const Vector3* vertices, const Vector3& direction, const Vector3& origin, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+	//Appends triangles whose bounds overlap the given bounds
+	void Overlap(const Bounds& bounds, std::vector<uint32_t>& triangles) const;
+
+	[[nodiscard]]
+	uint32_t Root() const;
+
+	[[nodiscard]]
+	const std::vector<Node>& Nodes() const;
+
+	[[nodiscard]]
+	const std::vector<uint32_t>& Triangles() const;
+
+private:
+	uint32_t BuildRange(const std::vector<Bounds>& triangleBounds, const std::vector<Vector3>& centroids, uint32_t begin, uint32_t end, uint32_t parent);
+	void RefitNode(const Vector3* vertices, uint32_t node, bool rotate);
+	void Rotate(uint32_t node);
+
+	std::vector<Node> nodes;
+	std::vector<uint32_t> triangles;
+	std::vector<uint32_t> leafOf;
+	std::vector<uint8_t> dirty;
+	uint32_t root = invalid;
+};
+
+//Triangle set that changes every frame
+//Changes are refit into a spare buffer which is then published, so queries keep using the previous tree and never wait
+//A spare buffer is one whose last reader let go of it, it is brought up to date by replaying the triangles changed since it was published
+//Only a buffer that missed a rebuild, or more changes than there are triangles, is copied whole, so the work per frame is proportional to the changes
+//When refitting degrades the tree past rebuildThreshold times its cost after the last build, a full rebuild starts on a background thread and replaces the tree once done
+//Caution: SetTriangle and Update must be called from a single thread, Acquire can be called from any thread !
+class DynamicBVH
+{
+public:
+	//Tree and the vertices it was fit to, immutable once published
+	struct Snapshot
+	{
+		BVH tree;
+		std::vector<Vector3> vertices;
+
+		bool Raycast(BVH::RaycastHit& hit, const Vector3& direction, const Vector3& origin, float maxDistance = std::numeric_limits<float>::infinity()) const;
+	};
+
+	explicit DynamicBVH(float rebuildThreshold = 1.5f);
+
+	//Waits for a running rebuild
+	~DynamicBVH();
+
+	DynamicBVH(const DynamicBVH&) = delete;
+	DynamicBVH& operator=(const DynamicBVH&) = delete;
+
+	//Builds the tree synchronously and publishes it
+	void Build(const Vector3* vertices, size_t triangleCount);
+
+	//Moves a triangle, the change is published by the next Update
+	void SetTriangle(uint32_t triangle, const Vector3& a, const Vector3& b, const Vector3& c);
+
+	//Publishes pending changes and finished rebuilds, call once per frame
+	void Update();
+
+	//Returns the current tree, it stays valid while the pointer is held
+	//Dropping the last pointer to a tree hands its buffer back, after that it can be refit and published again
+	[[nodiscard]]
+	std::shared_ptr<const Snapshot> Acquire() const;
+
+	//Returns true while a background rebuild is running
+	[[nodiscard]]
+	bool Rebuilding() const;
+
+	//Returns number of finished background rebuilds
+	[[nodiscard]]
+	size_t RebuildCount() const;
+
+private:
+	//Buffer that no reader can reach and the version of the changes it holds
+	struct Spare
+	{
+		std::unique_ptr<Snapshot> snapshot;
+		uint64_t version;
+	};
+
+	//Buffers handed back by readers, shared with published trees so it outlives the DynamicBVH while readers hold them
+	struct Recycler
+	{
+		std::mutex mutex;
+		std::vector<Spare> released;
+	};
+
+	void Publish(std::unique_ptr<Snapshot> snapshot);
+	Spare TakeSpare();
+	void StartRebuild();
+
+	float rebuildThreshold;
+	float builtCost = 0;
+	size_t rebuilds = 0;
+	std::vector<Vector3> vertices;
+	std::vector<uint32_t> dirty;
+	std::vector<uint8_t> isDirty;
+	std::shared_ptr<const Snapshot> front;
+	std::future<std::unique_ptr<Snapshot>> rebuild;
+
+	//Triangles changed by each published version, sorted by version
+	//Buffers older than logStart can not be brought up to date from the log and are copied whole
+	std::vector<std::pair<uint64_t, uint32_t>> changes;
+	std::vector<uint32_t> replay;
+	uint64_t version = 0;
+	uint64_t logStart = 0;
+	std::shared_ptr<Recycler> recycler = std::make_shared<Recycler>();
+};
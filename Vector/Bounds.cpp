@@ -0,0 +1,91 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: http://www.viva64.com
+
+#include "Bounds.h"
+#include <algorithm>
+
+Bounds Bounds::FromCenterExtents(const Vector3& center, const Vector3& extents)
+{
+	return Bounds(center - extents, center + extents);
+}
+
+Bounds Bounds::FromTriangle(const Vector3& a, const Vector3& b, const Vector3& c)
+{
+	return Bounds(
+		Vector3(std::min({ a.x, b.x, c.x }), std::min({ a.y, b.y, c.y }), std::min({ a.z, b.z, c.z })),
+		Vector3(std::max({ a.x, b.x, c.x }), std::max({ a.y, b.y, c.y }), std::max({ a.z, b.z, c.z })));
+}
+
+Bounds Bounds::Union(const Bounds& lhs, const Bounds& rhs)
+{
+	return Bounds(
+		Vector3(std::min(lhs.min.x, rhs.min.x), std::min(lhs.min.y, rhs.min.y), std::min(lhs.min.z, rhs.min.z)),
+		Vector3(std::max(lhs.max.x, rhs.max.x), std::max(lhs.max.y, rhs.max.y), std::max(lhs.max.z, rhs.max.z)));
+}
+
+bool Bounds::Overlaps(const Bounds& lhs, const Bounds& rhs)
+{
+	return lhs.min.x <= rhs.max.x && rhs.min.x <= lhs.max.x &&
+		lhs.min.y <= rhs.max.y && rhs.min.y <= lhs.max.y &&
+		lhs.min.z <= rhs.max.z && rhs.min.z <= lhs.max.z;
+}
+
+Vector3 Bounds::Center() const
+{
+	return (min + max) * 0.5f;
+}
+
+Vector3 Bounds::Extents() const
+{
+	return (max - min) * 0.5f;
+}
+
+float Bounds::SurfaceArea() const
+{
+	const Vector3 size = max - min;
+	if (size.x < 0 || size.y < 0 || size.z < 0) return 0;
+
+	return 2 * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+bool Bounds::Contains(const Vector3& point) const
+{
+	return point.x >= min.x && point.x <= max.x &&
+		point.y >= min.y && point.y <= max.y &&
+		point.z >= min.z && point.z <= max.z;
+}
+
+bool Bounds::RayIntersection(float& distance, const Vector3& origin, const Vector3& inverseDirection, const float maxDistance) const
+{
+	//Slab test, entry is the largest near plane distance and exit the smallest far plane distance
+	float entry = 0;
+	float exit = maxDistance;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float nearDistance = (min[axis] - origin[axis]) * inverseDirection[axis];
+		float farDistance = (max[axis] - origin[axis]) * inverseDirection[axis];
+		if (nearDistance > farDistance) std::swap(nearDistance, farDistance);
+		entry = std::max(entry, nearDistance);
+		exit = std::min(exit, farDistance);
+	}
+
+	distance = entry;
+	return entry <= exit;
+}
+
+void Bounds::Encapsulate(const Vector3& point)
+{
+	min = Vector3(std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z));
+	max = Vector3(std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z));
+}
+
+void Bounds::Encapsulate(const Bounds& other)
+{
+	*this = Union(*this, other);
+}
+
+std::string Bounds::ToString(int precision) const
+{
+	return "(" + min.ToString(precision) + "), (" + max.ToString(precision) + ")";
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "Vector.h"
+
+//Axis aligned bounding box defined by its minimum and maximum corners
+struct Bounds
+{
+	Vector3 min;
+	Vector3 max;
+
+	///Static methods
+	//Creates bounds from a center point and half size on each axis
+	static Bounds FromCenterExtents(const Vector3& center, const Vector3& extents);
+
+	//Creates the smallest bounds containing triangle a,b,c
+	static Bounds FromTriangle(const Vector3& a, const Vector3& b, const Vector3& c);
+
+	//Returns the smallest bounds containing both bounds
+	static Bounds Union(const Bounds& lhs, const Bounds& rhs);
+
+	//Checks if two bounds overlap, touching bounds are counted as overlapping
+	static bool Overlaps(const Bounds& lhs, const Bounds& rhs);
+
+	//Returns center of the bounds
+	[[nodiscard]]
+	Vector3 Center() const;
+
+	//Returns half size of the bounds on each axis
+	[[nodiscard]]
+	Vector3 Extents() const;
+
+	//Returns surface area of the bounds, used as cost metric by acceleration structures
+	[[nodiscard]]
+	float SurfaceArea() const;
+
+	//Checks if point is inside the bounds
+	[[nodiscard]]
+	bool Contains(const Vector3& point) const;
+
+	//Checks if a ray hits the bounds within maxDistance, distance to the entry point is saved to distance
+	//inverseDirection is one divided by each component of ray direction, so it can be computed once per ray
+	bool RayIntersection(float& distance, const Vector3& origin, const Vector3& inverseDirection, float maxDistance) const;
+
+	//Grows the bounds to include point
+	void Encapsulate(const Vector3& point);
+
+	//Grows the bounds to include other bounds
+	void Encapsulate(const Bounds& other);
+
+	[[nodiscard]]
+	std::string ToString(int precision = 2) const;
+
+	/// Constructors
+	//Default bounds are empty, encapsulating any point makes them valid
+	Bounds() : min(Vector3::positiveInfinity), max(Vector3::negativeInfinity) { ; }
+
+	Bounds(const Vector3& min, const Vector3& max) : min(min), max(max) { ; }
+};
@@ -0,0 +1,289 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: http://www.viva64.com
+
+#include "Broadphase.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define BROADPHASE_SSE
+#endif
+
+Bounds SweepAndPrune::MakeBounds(const Vector3& position, const Vector3& extents)
+{
+	//Negative extents would put a max endpoint before its min, the sweep relies on every box opening before it closes
+	const Bounds box = Bounds::FromCenterExtents(position, Vector3(std::fabs(extents.x), std::fabs(extents.y), std::fabs(extents.z)));
+
+	//A NaN on one axis is spread to all of them, otherwise confirming on the two other axes could still report the box
+	for (int axis = 0; axis < 3; axis++)
+	{
+		if (std::isnan(box.min[axis]) || std::isnan(box.max[axis]))
+			return Bounds(Vector3(NAN, NAN, NAN), Vector3(NAN, NAN, NAN));
+	}
+	return box;
+}
+
+float SweepAndPrune::SortValue(const float value)
+{
+	//NaN has no place in the order, it goes last where the box still opens before it closes and fails every overlap test
+	return value == value ? value : INFINITY;
+}
+
+uint32_t SweepAndPrune::Add(const Vector3& position, const Vector3& extents)
+{
+	uint32_t handle;
+	if (!freeHandles.empty())
+	{
+		handle = freeHandles.back();
+		freeHandles.pop_back();
+		boxes[handle] = MakeBounds(position, extents);
+		alive[handle] = 1;
+	}
+	else
+	{
+		handle = static_cast<uint32_t>(boxes.size());
+		boxes.push_back(MakeBounds(position, extents));
+		alive.push_back(1);
+		activeSlot.push_back(0);
+	}
+
+	//New endpoints are appended and moved into place by the next sort
+	for (int axis = 0; axis < 3; axis++)
+	{
+		endpoints[axis].push_back(Endpoint{ SortValue(boxes[handle].min[axis]), handle << 1 });
+		endpoints[axis].push_back(Endpoint{ SortValue(boxes[handle].max[axis]), handle << 1 | 1 });
+	}
+	pendingAdds++;
+
+	return handle;
+}
+
+void SweepAndPrune::Remove(const uint32_t handle)
+{
+	if (handle >= boxes.size() || !alive[handle]) return;
+
+	//Endpoints stay in place until the next sort compacts them, the handle is only reused after that
+	alive[handle] = 0;
+	pendingRemoves.push_back(handle);
+}
+
+void SweepAndPrune::Update(const uint32_t handle, const Vector3& position, const Vector3& extents)
+{
+	assert(handle < boxes.size() && alive[handle]);
+	boxes[handle] = MakeBounds(position, extents);
+}
+
+const Bounds& SweepAndPrune::GetBounds(const uint32_t handle) const
+{
+	assert(handle < boxes.size() && alive[handle]);
+	return boxes[handle];
+}
+
+size_t SweepAndPrune::Count() const
+{
+	return boxes.size() - freeHandles.size() - pendingRemoves.size();
+}
+
+int SweepAndPrune::SweepAxis() const
+{
+	return sweepAxis;
+}
+
+size_t SweepAndPrune::SwapCount() const
+{
+	return swaps;
+}
+
+bool SweepAndPrune::Less(const Endpoint& lhs, const Endpoint& rhs)
+{
+	//Min endpoints go first on ties so touching boxes are reported
+	if (lhs.value != rhs.value) return lhs.value < rhs.value;
+	return (lhs.data & 1) < (rhs.data & 1);
+}
+
+void SweepAndPrune::SortAxis(const int axis)
+{
+	std::vector<Endpoint>& list = endpoints[axis];
+
+	//Dropping removed endpoints keeps the order of the rest, so coherence is not lost
+	if (!pendingRemoves.empty())
+	{
+		list.erase(std::remove_if(list.begin(), list.end(),
+			[this](const Endpoint& e) { return !alive[e.data >> 1]; }), list.end());
+	}
+
+	for (Endpoint& e : list)
+	{
+		const Bounds& box = boxes[e.data >> 1];
+		e.value = SortValue((e.data & 1) ? box.max[axis] : box.min[axis]);
+	}
+
+	//Insertion sort degrades when many boxes were added at once, fall back to a full sort then
+	if (pendingAdds * 8 > list.size())
+	{
+		std::sort(list.begin(), list.end(), Less);
+		return;
+	}
+
+	for (size_t i = 1; i < list.size(); i++)
+	{
+		const Endpoint key = list[i];
+		size_t j = i;
+		while (j > 0 && Less(key, list[j - 1]))
+		{
+			list[j] = list[j - 1];
+			j--;
+		}
+		list[j] = key;
+		swaps += i - j;
+	}
+}
+
+size_t SweepAndPrune::CandidateCount(const int axis) const
+{
+	size_t open = 0;
+	size_t candidates = 0;
+
+	for (const Endpoint& e : endpoints[axis])
+	{
+		if (e.data & 1)
+		{
+			open--;
+		}
+		else
+		{
+			candidates += open;
+			open++;
+		}
+	}
+
+	return candidates;
+}
+
+void SweepAndPrune::Confirm(const uint32_t handle, const int axis1, const int axis2)
+{
+	const Bounds& box = boxes[handle];
+	const float min1 = box.min[axis1];
+	const float max1 = box.max[axis1];
+	const float min2 = box.min[axis2];
+	const float max2 = box.max[axis2];
+
+	const float* aMin1 = activeMin[0].data();
+	const float* aMax1 = activeMax[0].data();
+	const float* aMin2 = activeMin[1].data();
+	const float* aMax2 = activeMax[1].data();
+	const size_t count = active.size();
+	size_t i = 0;
+
+#ifdef BROADPHASE_SSE
+	const __m128 bMin1 = _mm_set1_ps(min1);
+	const __m128 bMax1 = _mm_set1_ps(max1);
+	const __m128 bMin2 = _mm_set1_ps(min2);
+	const __m128 bMax2 = _mm_set1_ps(max2);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 overlap = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(aMin1 + i), bMax1), _mm_cmple_ps(bMin1, _mm_loadu_ps(aMax1 + i)));
+		overlap = _mm_and_ps(overlap, _mm_cmple_ps(_mm_loadu_ps(aMin2 + i), bMax2));
+		overlap = _mm_and_ps(overlap, _mm_cmple_ps(bMin2, _mm_loadu_ps(aMax2 + i)));
+
+		int mask = _mm_movemask_ps(overlap);
+		while (mask)
+		{
+			int lane = 0;
+			while (!(mask & (1 << lane))) lane++;
+			mask &= mask - 1;
+
+			const uint32_t other = active[i + lane];
+			pairs.push_back(other < handle ? Pair{ other, handle } : Pair{ handle, other });
+		}
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		if (aMin1[i] <= max1 && min1 <= aMax1[i] && aMin2[i] <= max2 && min2 <= aMax2[i])
+		{
+			const uint32_t other = active[i];
+			pairs.push_back(other < handle ? Pair{ other, handle } : Pair{ handle, other });
+		}
+	}
+}
+
+void SweepAndPrune::Sweep(const int axis)
+{
+	const int axis1 = (axis + 1) % 3;
+	const int axis2 = (axis + 2) % 3;
+
+	active.clear();
+	for (int i = 0; i < 2; i++)
+	{
+		activeMin[i].clear();
+		activeMax[i].clear();
+	}
+
+	for (const Endpoint& e : endpoints[axis])
+	{
+		const uint32_t handle = e.data >> 1;
+
+		if (e.data & 1)
+		{
+			//Swap remove from active set
+			const uint32_t slot = activeSlot[handle];
+			const uint32_t last = static_cast<uint32_t>(active.size() - 1);
+			active[slot] = active[last];
+			activeSlot[active[slot]] = slot;
+			active.pop_back();
+			for (int i = 0; i < 2; i++)
+			{
+				activeMin[i][slot] = activeMin[i][last];
+				activeMax[i][slot] = activeMax[i][last];
+				activeMin[i].pop_back();
+				activeMax[i].pop_back();
+			}
+			continue;
+		}
+
+		Confirm(handle, axis1, axis2);
+
+		const Bounds& box = boxes[handle];
+		activeSlot[handle] = static_cast<uint32_t>(active.size());
+		active.push_back(handle);
+		activeMin[0].push_back(box.min[axis1]);
+		activeMax[0].push_back(box.max[axis1]);
+		activeMin[1].push_back(box.min[axis2]);
+		activeMax[1].push_back(box.max[axis2]);
+	}
+}
+
+const std::vector<SweepAndPrune::Pair>& SweepAndPrune::FindPairs()
+{
+	pairs.clear();
+	swaps = 0;
+
+	for (int axis = 0; axis < 3; axis++)
+		SortAxis(axis);
+	pendingAdds = 0;
+	freeHandles.insert(freeHandles.end(), pendingRemoves.begin(), pendingRemoves.end());
+	pendingRemoves.clear();
+
+	//Sweep the axis that produces the fewest candidates, the others only confirm
+	size_t best = CandidateCount(0);
+	sweepAxis = 0;
+	for (int axis = 1; axis < 3; axis++)
+	{
+		const size_t candidates = CandidateCount(axis);
+		if (candidates < best)
+		{
+			best = candidates;
+			sweepAxis = axis;
+		}
+	}
+
+	Sweep(sweepAxis);
+
+	return pairs;
+}
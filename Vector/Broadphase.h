@@ -0,0 +1,84 @@
+#pragma once
+#include "Bounds.h"
+#include <cstdint>
+#include <vector>
+
+//Incremental sweep and prune broadphase for moving boxes
+//Endpoints are kept sorted on all three axes and re-sorted with insertion sort every frame, which is close to linear when objects move little between frames
+//Pairs are found by sweeping the axis with fewest candidates and confirming candidates on the two other axes
+class SweepAndPrune
+{
+public:
+	//Pair of overlapping box handles, a is always smaller than b
+	struct Pair
+	{
+		uint32_t a;
+		uint32_t b;
+	};
+
+	//Adds a box and returns its handle. Handles of removed boxes are reused
+	//Negative extents are taken as their absolute value, a box with a NaN coordinate never overlaps anything
+	uint32_t Add(const Vector3& position, const Vector3& extents);
+
+	//Removes a box, its handle becomes invalid. Its endpoints are dropped by the next FindPairs call, which also frees the handle for reuse
+	void Remove(uint32_t handle);
+
+	//Moves or resizes a box, sorting is deferred to the next FindPairs call
+	//Caution: Handle must belong to a box that was not removed !
+	void Update(uint32_t handle, const Vector3& position, const Vector3& extents);
+
+	//Returns current bounds of a box
+	//Caution: Handle must belong to a box that was not removed !
+	[[nodiscard]]
+	const Bounds& GetBounds(uint32_t handle) const;
+
+	//Returns number of boxes in the broadphase
+	[[nodiscard]]
+	size_t Count() const;
+
+	//Sorts endpoints and returns all overlapping pairs
+	//Caution: Returned buffer is reused by the next call, copy it if it must outlive the frame !
+	const std::vector<Pair>& FindPairs();
+
+	//Returns the axis used by the last sweep, 0 = x, 1 = y, 2 = z
+	[[nodiscard]]
+	int SweepAxis() const;
+
+	//Returns number of endpoint swaps done by the last sort, a measure of frame to frame coherence
+	[[nodiscard]]
+	size_t SwapCount() const;
+
+private:
+	//Sorted endpoint, data holds handle << 1 and lowest bit is set for max endpoints
+	struct Endpoint
+	{
+		float value;
+		uint32_t data;
+	};
+
+	static Bounds MakeBounds(const Vector3& position, const Vector3& extents);
+	static float SortValue(float value);
+	static bool Less(const Endpoint& lhs, const Endpoint& rhs);
+
+	void SortAxis(int axis);
+	[[nodiscard]]
+	size_t CandidateCount(int axis) const;
+	void Sweep(int axis);
+	void Confirm(uint32_t handle, int axis1, int axis2);
+
+	std::vector<Bounds> boxes;
+	std::vector<uint8_t> alive;
+	std::vector<uint32_t> freeHandles;
+	std::vector<uint32_t> pendingRemoves;
+	std::vector<Endpoint> endpoints[3];
+	size_t pendingAdds = 0;
+	size_t swaps = 0;
+	int sweepAxis = 0;
+
+	//Reusable buffers, active boxes are stored as structure of arrays for the confirmation loop
+	std::vector<Pair> pairs;
+	std::vector<uint32_t> active;
+	std::vector<uint32_t> activeSlot;
+	std::vector<float> activeMin[2];
+	std::vector<float> activeMax[2];
+};
@@ -0,0 +1,495 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: http://www.viva64.com
+
+#include "ClosestPoint.h"
+#include <algorithm>
+#include <vector>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define CLOSESTPOINT_SSE
+#endif
+
+static float Clamp01(const float value)
+{
+	return std::min(std::max(value, 0.0f), 1.0f);
+}
+
+#ifdef CLOSESTPOINT_SSE
+//Four vectors in structure of arrays form, one lane per vector
+struct Vector3x4
+{
+	__m128 x;
+	__m128 y;
+	__m128 z;
+
+	static Vector3x4 Broadcast(const Vector3& v)
+	{
+		return Vector3x4{ _mm_set1_ps(v.x), _mm_set1_ps(v.y), _mm_set1_ps(v.z) };
+	}
+
+	//Loads v[0], v[stride], v[2 * stride] and v[3 * stride]
+	static Vector3x4 Load(const Vector3* v, const size_t stride = 1)
+	{
+		return Vector3x4{
+			_mm_setr_ps(v[0].x, v[stride].x, v[stride * 2].x, v[stride * 3].x),
+			_mm_setr_ps(v[0].y, v[stride].y, v[stride * 2].y, v[stride * 3].y),
+			_mm_setr_ps(v[0].z, v[stride].z, v[stride * 2].z, v[stride * 3].z) };
+	}
+
+	void Store(Vector3* v) const
+	{
+		float xs[4], ys[4], zs[4];
+		_mm_storeu_ps(xs, x);
+		_mm_storeu_ps(ys, y);
+		_mm_storeu_ps(zs, z);
+		for (int lane = 0; lane < 4; lane++)
+			v[lane] = Vector3(xs[lane], ys[lane], zs[lane]);
+	}
+
+	Vector3x4 operator + (const Vector3x4& p) const
+	{
+		return Vector3x4{ _mm_add_ps(x, p.x), _mm_add_ps(y, p.y), _mm_add_ps(z, p.z) };
+	}
+
+	Vector3x4 operator - (const Vector3x4& p) const
+	{
+		return Vector3x4{ _mm_sub_ps(x, p.x), _mm_sub_ps(y, p.y), _mm_sub_ps(z, p.z) };
+	}
+
+	Vector3x4 operator * (const __m128 p) const
+	{
+		return Vector3x4{ _mm_mul_ps(x, p), _mm_mul_ps(y, p), _mm_mul_ps(z, p) };
+	}
+};
+
+static __m128 Dot(const Vector3x4& lhs, const Vector3x4& rhs)
+{
+	return _mm_add_ps(_mm_add_ps(_mm_mul_ps(lhs.x, rhs.x), _mm_mul_ps(lhs.y, rhs.y)), _mm_mul_ps(lhs.z, rhs.z));
+}
+
+//Picks lanes of a where mask is set and lanes of b elsewhere
+static __m128 Select(const __m128 mask, const __m128 a, const __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static Vector3x4 Select(const __m128 mask, const Vector3x4& a, const Vector3x4& b)
+{
+	return Vector3x4{ Select(mask, a.x, b.x), Select(mask, a.y, b.y), Select(mask, a.z, b.z) };
+}
+
+//min and max return their second operand when either is NaN, value goes second so NaN passes through like in the scalar Clamp01
+static __m128 Clamp01(const __m128 value)
+{
+	return _mm_min_ps(_mm_set1_ps(1), _mm_max_ps(_mm_setzero_ps(), value));
+}
+
+//Divides where the denominator is not zero and returns zero elsewhere, so masked out lanes never hold inf or nan
+static __m128 SafeDivide(const __m128 numerator, const __m128 denominator)
+{
+	const __m128 nonZero = _mm_cmpneq_ps(denominator, _mm_setzero_ps());
+	return _mm_and_ps(nonZero, _mm_div_ps(numerator, Select(nonZero, denominator, _mm_set1_ps(1))));
+}
+
+static __m128 PointSegment4(Vector3x4& closest, const Vector3x4& point, const Vector3x4& a, const Vector3x4& b)
+{
+	const Vector3x4 ab = b - a;
+	//Only positive lengths divide, like the scalar version, so a NaN length gives t = 0 there too
+	const __m128 length = Dot(ab, ab);
+	const __m128 t = _mm_and_ps(_mm_cmpgt_ps(length, _mm_setzero_ps()), Clamp01(SafeDivide(Dot(point - a, ab), length)));
+	closest = a + ab * t;
+
+	const Vector3x4 offset = point - closest;
+	return Dot(offset, offset);
+}
+
+//Same Voronoi regions as the scalar version, but every region is computed and the right one is selected per lane
+static __m128 PointTriangle4(Vector3x4& closest, const Vector3x4& point, const Vector3x4& a, const Vector3x4& b, const Vector3x4& c)
+{
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1);
+	const Vector3x4 ab = b - a;
+	const Vector3x4 ac = c - a;
+
+	const Vector3x4 ap = point - a;
+	const __m128 d1 = Dot(ab, ap);
+	const __m128 d2 = Dot(ac, ap);
+	const Vector3x4 bp = point - b;
+	const __m128 d3 = Dot(ab, bp);
+	const __m128 d4 = Dot(ac, bp);
+	const Vector3x4 cp = point - c;
+	const __m128 d5 = Dot(ab, cp);
+	const __m128 d6 = Dot(ac, cp);
+
+	const __m128 va = _mm_sub_ps(_mm_mul_ps(d3, d6), _mm_mul_ps(d5, d4));
+	const __m128 vb = _mm_sub_ps(_mm_mul_ps(d5, d2), _mm_mul_ps(d1, d6));
+	const __m128 vc = _mm_sub_ps(_mm_mul_ps(d1, d4), _mm_mul_ps(d3, d2));
+
+	//Every region builds its point from the same terms as the scalar version, so infinite vertices give NaN in the same lanes
+	//Face first, then edge and vertex regions, later ones take priority like the early returns of the scalar version
+	const __m128 sum = _mm_add_ps(_mm_add_ps(va, vb), vc);
+	const __m128 inverseSum = _mm_div_ps(one, sum);
+	closest = Select(_mm_cmpneq_ps(sum, zero), a + ab * _mm_mul_ps(vb, inverseSum) + ac * _mm_mul_ps(vc, inverseSum), a);
+
+	const __m128 d43 = _mm_sub_ps(d4, d3);
+	const __m128 d56 = _mm_sub_ps(d5, d6);
+	const __m128 d4356 = _mm_add_ps(d43, d56);
+	const __m128 onBC = _mm_and_ps(_mm_and_ps(_mm_cmple_ps(va, zero), _mm_cmpgt_ps(d4356, zero)), _mm_and_ps(_mm_cmpge_ps(d43, zero), _mm_cmpge_ps(d56, zero)));
+	closest = Select(onBC, b + (c - b) * _mm_div_ps(d43, d4356), closest);
+
+	const __m128 onAC = _mm_and_ps(_mm_and_ps(_mm_cmple_ps(vb, zero), _mm_cmpgt_ps(d2, d6)), _mm_and_ps(_mm_cmpge_ps(d2, zero), _mm_cmple_ps(d6, zero)));
+	closest = Select(onAC, a + ac * _mm_div_ps(d2, _mm_sub_ps(d2, d6)), closest);
+
+	const __m128 onC = _mm_and_ps(_mm_cmpge_ps(d6, zero), _mm_cmple_ps(d5, d6));
+	closest = Select(onC, c, closest);
+
+	const __m128 onAB = _mm_and_ps(_mm_and_ps(_mm_cmple_ps(vc, zero), _mm_cmpgt_ps(d1, d3)), _mm_and_ps(_mm_cmpge_ps(d1, zero), _mm_cmple_ps(d3, zero)));
+	closest = Select(onAB, a + ab * _mm_div_ps(d1, _mm_sub_ps(d1, d3)), closest);
+
+	const __m128 onB = _mm_and_ps(_mm_cmpge_ps(d3, zero), _mm_cmple_ps(d4, d3));
+	closest = Select(onB, b, closest);
+
+	const __m128 onA = _mm_and_ps(_mm_cmple_ps(d1, zero), _mm_cmple_ps(d2, zero));
+	closest = Select(onA, a, closest);
+
+	const Vector3x4 offset = point - closest;
+	return Dot(offset, offset);
+}
+
+static __m128 SegmentSegment4(Vector3x4& closestP, Vector3x4& closestQ, const Vector3x4& p0, const Vector3x4& p1, const Vector3x4& q0, const Vector3x4& q1)
+{
+	const __m128 zero = _mm_setzero_ps();
+	const Vector3x4 d1 = p1 - p0;
+	const Vector3x4 d2 = q1 - q0;
+	const Vector3x4 r = p0 - q0;
+	const __m128 a = Dot(d1, d1);
+	const __m128 e = Dot(d2, d2);
+	const __m128 f = Dot(d2, r);
+	const __m128 c = Dot(d1, r);
+	const __m128 b = Dot(d1, d2);
+
+	//Closest points of the infinite lines, parallel lines start from s = 0
+	const __m128 denominator = _mm_sub_ps(_mm_mul_ps(a, e), _mm_mul_ps(b, b));
+	__m128 s = Clamp01(SafeDivide(_mm_sub_ps(_mm_mul_ps(b, f), _mm_mul_ps(c, e)), denominator));
+	__m128 t = SafeDivide(_mm_add_ps(_mm_mul_ps(b, s), f), e);
+
+	//Clamp t to the segment and recompute s for the clamped t
+	const __m128 below = _mm_cmplt_ps(t, zero);
+	const __m128 above = _mm_cmpgt_ps(t, _mm_set1_ps(1));
+	s = Select(below, Clamp01(SafeDivide(_mm_sub_ps(zero, c), a)), s);
+	s = Select(above, Clamp01(SafeDivide(_mm_sub_ps(b, c), a)), s);
+	t = Clamp01(t);
+
+	//Degenerate segments are points, a point segment keeps s or t at zero
+	const __m128 pointQ = _mm_cmpeq_ps(e, zero);
+	s = Select(pointQ, Clamp01(SafeDivide(_mm_sub_ps(zero, c), a)), s);
+	t = Select(pointQ, zero, t);
+	const __m128 pointP = _mm_cmpeq_ps(a, zero);
+	s = Select(pointP, zero, s);
+	t = Select(pointP, Clamp01(SafeDivide(f, e)), t);
+
+	closestP = p0 + d1 * s;
+	closestQ = q0 + d2 * t;
+	const Vector3x4 offset = closestP - closestQ;
+	return Dot(offset, offset);
+}
+#endif
+
+float ClosestPoint::PointSegment(Vector3& closest, const Vector3& point, const Vector3& a, const Vector3& b)
+{
+	const Vector3 ab = b - a;
+	const float length = Vector3::Dot(ab, ab);
+	const float t = length > 0 ? Clamp01(Vector3::Dot(point - a, ab) / length) : 0;
+	closest = a + ab * t;
+	return (point - closest).SqrMagnitude();
+}
+
+void ClosestPoint::PointSegment(Vector3* closest, float* sqrDistances, const Vector3* points, const size_t count, const Vector3& a, const Vector3& b)
+{
+	size_t i = 0;
+
+#ifdef CLOSESTPOINT_SSE
+	const Vector3x4 a4 = Vector3x4::Broadcast(a);
+	const Vector3x4 b4 = Vector3x4::Broadcast(b);
+	for (; i + 4 <= count; i += 4)
+	{
+		Vector3x4 result;
+		_mm_storeu_ps(sqrDistances + i, PointSegment4(result, Vector3x4::Load(points + i), a4, b4));
+		result.Store(closest + i);
+	}
+#endif
+
+	for (; i < count; i++)
+		sqrDistances[i] = PointSegment(closest[i], points[i], a, b);
+}
+
+float ClosestPoint::PointTriangle(Vector3& closest, const Vector3& point, const Vector3& a, const Vector3& b, const Vector3& c)
+{
+	//Finds the Voronoi region of the triangle that contains the point, from Ericson's "Real-Time Collision Detection"
+	const Vector3 ab = b - a;
+	const Vector3 ac = c - a;
+	const Vector3 ap = point - a;
+	const float d1 = Vector3::Dot(ab, ap);
+	const float d2 = Vector3::Dot(ac, ap);
+	if (d1 <= 0 && d2 <= 0)
+	{
+		closest = a;
+		return ap.SqrMagnitude();
+	}
+
+	const Vector3 bp = point - b;
+	const float d3 = Vector3::Dot(ab, bp);
+	const float d4 = Vector3::Dot(ac, bp);
+	if (d3 >= 0 && d4 <= d3)
+	{
+		closest = b;
+		return bp.SqrMagnitude();
+	}
+
+	const float vc = d1 * d4 - d3 * d2;
+	//Edge regions also need a nonzero edge, a degenerate triangle with two equal vertices would divide zero by zero
+	if (vc <= 0 && d1 >= 0 && d3 <= 0 && d1 > d3)
+	{
+		closest = a + ab * (d1 / (d1 - d3));
+		return (point - closest).SqrMagnitude();
+	}
+
+	const Vector3 cp = point - c;
+	const float d5 = Vector3::Dot(ab, cp);
+	const float d6 = Vector3::Dot(ac, cp);
+	if (d6 >= 0 && d5 <= d6)
+	{
+		closest = c;
+		return cp.SqrMagnitude();
+	}
+
+	const float vb = d5 * d2 - d1 * d6;
+	if (vb <= 0 && d2 >= 0 && d6 <= 0 && d2 > d6)
+	{
+		closest = a + ac * (d2 / (d2 - d6));
+		return (point - closest).SqrMagnitude();
+	}
+
+	const float va = d3 * d6 - d5 * d4;
+	if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0 && (d4 - d3) + (d5 - d6) > 0)
+	{
+		closest = b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+		return (point - closest).SqrMagnitude();
+	}
+
+	const float sum = va + vb + vc;
+	closest = sum != 0 ? a + ab * (vb / sum) + ac * (vc / sum) : a;
+	return (point - closest).SqrMagnitude();
+}
+
+void ClosestPoint::PointTriangle(Vector3* closest, float* sqrDistances, const Vector3* points, const size_t count, const Vector3& a, const Vector3& b, const Vector3& c)
+{
+	size_t i = 0;
+
+#ifdef CLOSESTPOINT_SSE
+	const Vector3x4 a4 = Vector3x4::Broadcast(a);
+	const Vector3x4 b4 = Vector3x4::Broadcast(b);
+	const Vector3x4 c4 = Vector3x4::Broadcast(c);
+	for (; i + 4 <= count; i += 4)
+	{
+		Vector3x4 result;
+		_mm_storeu_ps(sqrDistances + i, PointTriangle4(result, Vector3x4::Load(points + i), a4, b4, c4));
+		result.Store(closest + i);
+	}
+#endif
+
+	for (; i < count; i++)
+		sqrDistances[i] = PointTriangle(closest[i], points[i], a, b, c);
+}
+
+float ClosestPoint::SegmentSegment(Vector3& closestP, Vector3& closestQ, const Vector3& p0, const Vector3& p1, const Vector3& q0, const Vector3& q1)
+{
+	//Closest points of the infinite lines clamped to the segments, from Ericson's "Real-Time Collision Detection"
+	const Vector3 d1 = p1 - p0;
+	const Vector3 d2 = q1 - q0;
+	const Vector3 r = p0 - q0;
+	const float a = Vector3::Dot(d1, d1);
+	const float e = Vector3::Dot(d2, d2);
+	const float f = Vector3::Dot(d2, r);
+
+	float s = 0;
+	float t = 0;
+	if (a == 0 && e == 0)
+	{
+		//Both segments are points
+	}
+	else if (a == 0)
+	{
+		t = Clamp01(f / e);
+	}
+	else
+	{
+		const float c = Vector3::Dot(d1, r);
+		if (e == 0)
+		{
+			s = Clamp01(-c / a);
+		}
+		else
+		{
+			const float b = Vector3::Dot(d1, d2);
+			const float denominator = a * e - b * b;
+			s = denominator != 0 ? Clamp01((b * f - c * e) / denominator) : 0;
+			t = (b * s + f) / e;
+
+			if (t < 0)
+			{
+				t = 0;
+				s = Clamp01(-c / a);
+			}
+			else if (t > 1)
+			{
+				t = 1;
+				s = Clamp01((b - c) / a);
+			}
+		}
+	}
+
+	closestP = p0 + d1 * s;
+	closestQ = q0 + d2 * t;
+	return (closestP - closestQ).SqrMagnitude();
+}
+
+void ClosestPoint::SegmentSegment(Vector3* closestP, Vector3* closestQ, float* sqrDistances, const Vector3* points, const size_t segmentCount, const Vector3& q0, const Vector3& q1)
+{
+	size_t i = 0;
+
+#ifdef CLOSESTPOINT_SSE
+	const Vector3x4 q04 = Vector3x4::Broadcast(q0);
+	const Vector3x4 q14 = Vector3x4::Broadcast(q1);
+	for (; i + 4 <= segmentCount; i += 4)
+	{
+		Vector3x4 resultP, resultQ;
+		_mm_storeu_ps(sqrDistances + i, SegmentSegment4(resultP, resultQ, Vector3x4::Load(points + i * 2, 2), Vector3x4::Load(points + i * 2 + 1, 2), q04, q14));
+		resultP.Store(closestP + i);
+		resultQ.Store(closestQ + i);
+	}
+#endif
+
+	for (; i < segmentCount; i++)
+		sqrDistances[i] = SegmentSegment(closestP[i], closestQ[i], points[i * 2], points[i * 2 + 1], q0, q1);
+}
+
+float ClosestPoint::PointBounds(Vector3& closest, const Vector3& point, const Bounds& bounds)
+{
+	closest = Vector3(
+		std::min(std::max(point.x, bounds.min.x), bounds.max.x),
+		std::min(std::max(point.y, bounds.min.y), bounds.max.y),
+		std::min(std::max(point.z, bounds.min.z), bounds.max.z));
+	return (point - closest).SqrMagnitude();
+}
+
+void ClosestPoint::PointBounds(Vector3* closest, float* sqrDistances, const Vector3* points, const size_t count, const Bounds& bounds)
+{
+	size_t i = 0;
+
+#ifdef CLOSESTPOINT_SSE
+	const Vector3x4 min = Vector3x4::Broadcast(bounds.min);
+	const Vector3x4 max = Vector3x4::Broadcast(bounds.max);
+	for (; i + 4 <= count; i += 4)
+	{
+		const Vector3x4 point = Vector3x4::Load(points + i);
+		//Point goes second, so NaN components pass through and NaN bounds are ignored like with std::min and std::max
+		const Vector3x4 result{
+			_mm_min_ps(max.x, _mm_max_ps(min.x, point.x)),
+			_mm_min_ps(max.y, _mm_max_ps(min.y, point.y)),
+			_mm_min_ps(max.z, _mm_max_ps(min.z, point.z)) };
+		const Vector3x4 offset = point - result;
+		_mm_storeu_ps(sqrDistances + i, Dot(offset, offset));
+		result.Store(closest + i);
+	}
+#endif
+
+	for (; i < count; i++)
+		sqrDistances[i] = PointBounds(closest[i], points[i], bounds);
+}
+
+bool ClosestPoint::PointMesh(MeshHit& hit, const Vector3& point, const Vector3* vertices, const size_t triangleCount, const BVH* tree, const float maxSqrDistance)
+{
+	float best = maxSqrDistance;
+	bool found = false;
+	const auto test = [&](const uint32_t triangle)
+	{
+		Vector3 closest;
+		const float sqrDistance = PointTriangle(closest, point, vertices[triangle * 3], vertices[triangle * 3 + 1], vertices[triangle * 3 + 2]);
+		if (sqrDistance >= best) return;
+
+		best = sqrDistance;
+		hit.point = closest;
+		hit.sqrDistance = sqrDistance;
+		hit.triangle = triangle;
+		found = true;
+	};
+
+	if (tree == nullptr || tree->Root() == BVH::invalid)
+	{
+		size_t i = 0;
+
+#ifdef CLOSESTPOINT_SSE
+		//Four triangles against the point at a time, only the lane that improves on the best hit is written
+		const Vector3x4 point4 = Vector3x4::Broadcast(point);
+		for (; i + 4 <= triangleCount; i += 4)
+		{
+			Vector3x4 closest;
+			const __m128 sqrDistances = PointTriangle4(closest, point4, Vector3x4::Load(vertices + i * 3, 3), Vector3x4::Load(vertices + i * 3 + 1, 3), Vector3x4::Load(vertices + i * 3 + 2, 3));
+			if (_mm_movemask_ps(_mm_cmplt_ps(sqrDistances, _mm_set1_ps(best))) == 0) continue;
+
+			float lanes[4];
+			Vector3 points[4];
+			_mm_storeu_ps(lanes, sqrDistances);
+			closest.Store(points);
+			for (int lane = 0; lane < 4; lane++)
+			{
+				if (lanes[lane] >= best) continue;
+
+				best = lanes[lane];
+				hit.point = points[lane];
+				hit.sqrDistance = lanes[lane];
+				hit.triangle = static_cast<uint32_t>(i + lane);
+				found = true;
+			}
+		}
+#endif
+
+		for (; i < triangleCount; i++)
+			test(static_cast<uint32_t>(i));
+		return found;
+	}
+
+	const std::vector<BVH::Node>& nodes = tree->Nodes();
+	const std::vector<uint32_t>& triangles = tree->Triangles();
+
+	thread_local std::vector<uint32_t> stack;
+	stack.clear();
+	stack.push_back(tree->Root());
+
+	Vector3 closest;
+	while (!stack.empty())
+	{
+		const BVH::Node& node = nodes[stack.back()];
+		stack.pop_back();
+
+		if (PointBounds(closest, point, node.bounds) >= best) continue;
+
+		if (node.count == 0)
+		{
+			//Visit the nearer child first so the far one is more likely to be culled by best
+			const float first = PointBounds(closest, point, nodes[node.first].bounds);
+			const float second = PointBounds(closest, point, nodes[node.second].bounds);
+			stack.push_back(first < second ? node.second : node.first);
+			stack.push_back(first < second ? node.first : node.second);
+			continue;
+		}
+
+		for (uint32_t i = node.first; i < node.first + node.count; i++)
+			test(triangles[i]);
+	}
+
+	return found;
+}
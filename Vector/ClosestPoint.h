@@ -0,0 +1,44 @@
+#pragma once
+#include "Vector.h"
+#include "Bounds.h"
+#include "BVH.h"
+#include <cstdint>
+#include <limits>
+
+//Closest points and squared distances between points, segments, triangles and bounds
+//Every query returns the squared distance, take its square root only when the actual distance is needed
+//Batch versions test many points or segments against one shape, four at a time with SSE where available
+struct ClosestPoint
+{
+	struct MeshHit
+	{
+		Vector3 point;
+		float sqrDistance;
+		uint32_t triangle;
+	};
+
+	//Closest point to point on segment a-b
+	static float PointSegment(Vector3& closest, const Vector3& point, const Vector3& a, const Vector3& b);
+
+	static void PointSegment(Vector3* closest, float* sqrDistances, const Vector3* points, size_t count, const Vector3& a, const Vector3& b);
+
+	//Closest point to point on triangle a,b,c
+	static float PointTriangle(Vector3& closest, const Vector3& point, const Vector3& a, const Vector3& b, const Vector3& c);
+
+	static void PointTriangle(Vector3* closest, float* sqrDistances, const Vector3* points, size_t count, const Vector3& a, const Vector3& b, const Vector3& c);
+
+	//Closest points between segments p0-p1 and q0-q1, saved to closestP and closestQ
+	static float SegmentSegment(Vector3& closestP, Vector3& closestQ, const Vector3& p0, const Vector3& p1, const Vector3& q0, const Vector3& q1);
+
+	//Every two consecutive points form a segment that is tested against q0-q1
+	static void SegmentSegment(Vector3* closestP, Vector3* closestQ, float* sqrDistances, const Vector3* points, size_t segmentCount, const Vector3& q0, const Vector3& q1);
+
+	//Closest point to point inside the bounds, distance is zero if point is inside
+	static float PointBounds(Vector3& closest, const Vector3& point, const Bounds& bounds);
+
+	static void PointBounds(Vector3* closest, float* sqrDistances, const Vector3* points, size_t count, const Bounds& bounds);
+
+	//Finds the closest triangle of a triangle soup within maxSqrDistance, returns true if there is one
+	//With a tree built over the same vertices only the nodes that can be closer than the best hit so far are visited, otherwise every triangle is tested
+	static bool PointMesh(MeshHit& hit, const Vector3& point, const Vector3* vertices, size_t triangleCount, const BVH* tree = nullptr, float maxSqrDistance = std::numeric_limits<float>::infinity());
+};
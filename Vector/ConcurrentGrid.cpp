@@ -0,0 +1,394 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: http://www.viva64.com
+
+#include "ConcurrentGrid.h"
+#include "VectorHash.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <thread>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define CONCURRENTGRID_SSE
+#endif
+
+//Points inserted since the last Freeze, storage is allocated in blocks on first use so that capacity costs only the block table up front
+struct ConcurrentGrid::Live
+{
+	static constexpr uint32_t blockShift = 12;
+	static constexpr uint32_t blockSize = 1 << blockShift;
+
+	struct Entry
+	{
+		Vector3 point;
+		//Index of the next entry in the same bucket
+		uint32_t next;
+	};
+
+	struct Block
+	{
+		Entry entries[blockSize];
+	};
+
+	Live(const uint32_t base, const size_t capacity, const size_t bucketCount) : base(base), capacity(capacity),
+		blocks(new std::atomic<Block*>[(capacity + blockSize - 1) / blockSize]), heads(new std::atomic<uint32_t>[bucketCount])
+	{
+		for (size_t i = 0; i < (capacity + blockSize - 1) / blockSize; i++)
+			blocks[i].store(nullptr, std::memory_order_relaxed);
+		for (size_t i = 0; i < bucketCount; i++)
+			heads[i].store(invalid, std::memory_order_relaxed);
+	}
+
+	~Live()
+	{
+		for (size_t i = 0; i < (capacity + blockSize - 1) / blockSize; i++)
+			delete blocks[i].load(std::memory_order_relaxed);
+	}
+
+	Live(const Live&) = delete;
+	Live& operator=(const Live&) = delete;
+
+	//Reserves count consecutive entries, returns false when they do not fit
+	bool Reserve(size_t& first, const size_t count)
+	{
+		size_t current = reserved.load(std::memory_order_relaxed);
+		do
+		{
+			if (count > capacity - current) return false;
+		} while (!reserved.compare_exchange_weak(current, current + count, std::memory_order_relaxed));
+
+		first = current;
+		return true;
+	}
+
+	//Returns entry for writing, the first thread to touch a block allocates it
+	Entry& Claim(const size_t index)
+	{
+		std::atomic<Block*>& slot = blocks[index >> blockShift];
+		Block* block = slot.load(std::memory_order_acquire);
+		if (block == nullptr)
+		{
+			Block* allocated = new Block;
+			if (slot.compare_exchange_strong(block, allocated, std::memory_order_acq_rel, std::memory_order_acquire)) block = allocated;
+			else delete allocated;
+		}
+		return block->entries[index & (blockSize - 1)];
+	}
+
+	[[nodiscard]]
+	const Entry& Get(const size_t index) const
+	{
+		return blocks[index >> blockShift].load(std::memory_order_acquire)->entries[index & (blockSize - 1)];
+	}
+
+	//Makes a written entry visible to readers of its bucket
+	void Link(Entry& entry, const uint32_t index, const uint32_t bucket)
+	{
+		uint32_t head = heads[bucket].load(std::memory_order_relaxed);
+		do
+		{
+			entry.next = head;
+		} while (!heads[bucket].compare_exchange_weak(head, index, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	uint32_t base;
+	size_t capacity;
+	std::atomic<size_t> reserved{ 0 };
+	std::unique_ptr<std::atomic<Block*>[]> blocks;
+	std::unique_ptr<std::atomic<uint32_t>[]> heads;
+};
+
+//Points grouped by bucket, points of bucket b are [offsets[b], offsets[b + 1]) stored as structure of arrays
+struct ConcurrentGrid::Frozen
+{
+	std::vector<uint32_t> offsets;
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> z;
+	std::vector<uint32_t> ids;
+};
+
+//Both layouts are replaced together so that readers never see a point twice or miss one during Freeze
+struct ConcurrentGrid::State
+{
+	std::unique_ptr<Frozen> frozen;
+	std::unique_ptr<Live> live;
+};
+
+//Registers the calling thread as a reader for its lifetime, states retired while it exists are not freed
+class ConcurrentGrid::Pin
+{
+public:
+	explicit Pin(const ConcurrentGrid& grid)
+	{
+		const size_t start = std::hash<std::thread::id>()(std::this_thread::get_id());
+		for (size_t attempt = 0;; attempt++)
+		{
+			std::atomic<uint64_t>& candidate = grid.readers[(start + attempt) % grid.readerCount];
+			uint64_t expected = 0;
+			if (candidate.load(std::memory_order_relaxed) == 0 && candidate.compare_exchange_strong(expected, grid.epoch.load()))
+			{
+				slot = &candidate;
+				break;
+			}
+			if (attempt % grid.readerCount == grid.readerCount - 1) std::this_thread::yield();
+		}
+
+		//Loaded after the slot is taken, so a state retired before this load was already replaced and cannot be returned
+		state = grid.state.load();
+	}
+
+	~Pin()
+	{
+		slot->store(0, std::memory_order_release);
+	}
+
+	Pin(const Pin&) = delete;
+	Pin& operator=(const Pin&) = delete;
+
+	const State* state;
+
+private:
+	std::atomic<uint64_t>* slot = nullptr;
+};
+
+ConcurrentGrid::ConcurrentGrid(const float cellSize, const size_t capacity, const uint32_t bucketCount, const unsigned maxReaders) :
+	cellSize(cellSize), inverseCellSize(1.0 / cellSize), capacity(std::min<size_t>(capacity, invalid)), readerCount(std::max(1u, maxReaders)),
+	epoch(1), readers(new std::atomic<uint64_t>[std::max(1u, maxReaders)])
+{
+	uint32_t buckets = 1;
+	while (buckets < bucketCount && buckets < 0x80000000u)
+		buckets <<= 1;
+	bucketMask = buckets - 1;
+
+	for (unsigned i = 0; i < readerCount; i++)
+		readers[i].store(0, std::memory_order_relaxed);
+
+	State* initial = new State;
+	initial->frozen = std::make_unique<Frozen>();
+	initial->frozen->offsets.assign(static_cast<size_t>(bucketMask) + 2, 0);
+	initial->live = std::make_unique<Live>(0, this->capacity, static_cast<size_t>(bucketMask) + 1);
+	state.store(initial);
+}
+
+ConcurrentGrid::~ConcurrentGrid()
+{
+	delete state.load();
+	for (const std::pair<uint64_t, State*>& old : retired)
+		delete old.second;
+}
+
+//Cells are 64 bit like the ones of VectorMap, points far out get cells of their own instead of piling up in a border cell and NaN goes to a cell no finite point shares
+void ConcurrentGrid::Cell(int64_t& x, int64_t& y, int64_t& z, const Vector3& point) const
+{
+	x = VectorCells::Cell(point.x, inverseCellSize);
+	y = VectorCells::Cell(point.y, inverseCellSize);
+	z = VectorCells::Cell(point.z, inverseCellSize);
+}
+
+uint32_t ConcurrentGrid::Bucket(const int64_t x, const int64_t y, const int64_t z) const
+{
+	const int64_t cells[3] = { x, y, z };
+	return static_cast<uint32_t>(VectorCells::Hash(cells, 3)) & bucketMask;
+}
+
+uint32_t ConcurrentGrid::Bucket(const Vector3& point) const
+{
+	int64_t x, y, z;
+	Cell(x, y, z, point);
+	return Bucket(x, y, z);
+}
+
+uint32_t ConcurrentGrid::Insert(const Vector3& point)
+{
+	return Insert(&point, 1);
+}
+
+uint32_t ConcurrentGrid::Insert(const Vector3* points, const size_t count)
+{
+	Live& live = *state.load(std::memory_order_acquire)->live;
+
+	size_t first;
+	if (count == 0 || !live.Reserve(first, count)) return invalid;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		Live::Entry& entry = live.Claim(first + i);
+		entry.point = points[i];
+		live.Link(entry, static_cast<uint32_t>(first + i), Bucket(points[i]));
+	}
+
+	return live.base + static_cast<uint32_t>(first);
+}
+
+void ConcurrentGrid::Query(std::vector<Hit>& hits, const Vector3& center, const float radius) const
+{
+	const Pin pin(*this);
+	const Frozen& frozen = *pin.state->frozen;
+	const Live& live = *pin.state->live;
+
+	//Buckets of the covered cells, two cells can share a bucket so they are deduplicated before scanning
+	thread_local std::vector<uint32_t> buckets;
+	buckets.clear();
+
+	int64_t minX, minY, minZ, maxX, maxY, maxZ;
+	Cell(minX, minY, minZ, center - Vector3(radius, radius, radius));
+	Cell(maxX, maxY, maxZ, center + Vector3(radius, radius, radius));
+	const double cellCount = (static_cast<double>(maxX) - minX + 1) * (static_cast<double>(maxY) - minY + 1) * (static_cast<double>(maxZ) - minZ + 1);
+	if (cellCount > bucketMask)
+	{
+		for (uint32_t bucket = 0; bucket <= bucketMask; bucket++)
+			buckets.push_back(bucket);
+	}
+	else
+	{
+		for (int64_t z = minZ; z <= maxZ; z++)
+			for (int64_t y = minY; y <= maxY; y++)
+				for (int64_t x = minX; x <= maxX; x++)
+					buckets.push_back(Bucket(x, y, z));
+		std::sort(buckets.begin(), buckets.end());
+		buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+	}
+
+	const float sqrRadius = radius * radius;
+	for (const uint32_t bucket : buckets)
+	{
+		uint32_t i = frozen.offsets[bucket];
+		const uint32_t end = frozen.offsets[bucket + 1];
+
+#ifdef CONCURRENTGRID_SSE
+		const __m128 centerX = _mm_set1_ps(center.x), centerY = _mm_set1_ps(center.y), centerZ = _mm_set1_ps(center.z);
+		const __m128 sqrRadius4 = _mm_set1_ps(sqrRadius);
+		for (; i + 4 <= end; i += 4)
+		{
+			const __m128 dx = _mm_sub_ps(_mm_loadu_ps(frozen.x.data() + i), centerX);
+			const __m128 dy = _mm_sub_ps(_mm_loadu_ps(frozen.y.data() + i), centerY);
+			const __m128 dz = _mm_sub_ps(_mm_loadu_ps(frozen.z.data() + i), centerZ);
+			const __m128 sqrDistance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+			const int inside = _mm_movemask_ps(_mm_cmple_ps(sqrDistance, sqrRadius4));
+			if (inside == 0) continue;
+
+			for (uint32_t lane = 0; lane < 4; lane++)
+				if (inside & (1 << lane)) hits.push_back({ frozen.ids[i + lane], Vector3(frozen.x[i + lane], frozen.y[i + lane], frozen.z[i + lane]) });
+		}
+#endif
+
+		for (; i < end; i++)
+		{
+			const Vector3 point(frozen.x[i], frozen.y[i], frozen.z[i]);
+			if ((point - center).SqrMagnitude() <= sqrRadius) hits.push_back({ frozen.ids[i], point });
+		}
+
+		for (uint32_t index = live.heads[bucket].load(std::memory_order_acquire); index != invalid;)
+		{
+			const Live::Entry& entry = live.Get(index);
+			if ((entry.point - center).SqrMagnitude() <= sqrRadius) hits.push_back({ live.base + index, entry.point });
+			index = entry.next;
+		}
+	}
+}
+
+void ConcurrentGrid::Freeze()
+{
+	const State& current = *state.load();
+	const Frozen& previous = *current.frozen;
+	const Live& live = *current.live;
+	const size_t previousCount = previous.ids.size();
+	const size_t total = previousCount + live.reserved.load(std::memory_order_acquire);
+
+	const auto point = [&](const size_t i)
+	{
+		return i < previousCount ? Vector3(previous.x[i], previous.y[i], previous.z[i]) : live.Get(i - previousCount).point;
+	};
+
+	//Counting sort by bucket, scanning a bucket then touches only contiguous memory
+	std::unique_ptr<Frozen> frozen = std::make_unique<Frozen>();
+	std::vector<uint32_t> bucketOf(total);
+	frozen->offsets.assign(static_cast<size_t>(bucketMask) + 2, 0);
+	for (size_t i = 0; i < total; i++)
+	{
+		bucketOf[i] = Bucket(point(i));
+		frozen->offsets[bucketOf[i] + 1]++;
+	}
+	for (size_t bucket = 0; bucket <= bucketMask; bucket++)
+		frozen->offsets[bucket + 1] += frozen->offsets[bucket];
+
+	frozen->x.resize(total);
+	frozen->y.resize(total);
+	frozen->z.resize(total);
+	frozen->ids.resize(total);
+	std::vector<uint32_t> cursor(frozen->offsets.begin(), frozen->offsets.end() - 1);
+	for (size_t i = 0; i < total; i++)
+	{
+		const Vector3 p = point(i);
+		const uint32_t slot = cursor[bucketOf[i]]++;
+		frozen->x[slot] = p.x;
+		frozen->y[slot] = p.y;
+		frozen->z[slot] = p.z;
+		frozen->ids[slot] = i < previousCount ? previous.ids[i] : live.base + static_cast<uint32_t>(i - previousCount);
+	}
+
+	State* next = new State;
+	next->frozen = std::move(frozen);
+	next->live = std::make_unique<Live>(live.base + static_cast<uint32_t>(live.reserved.load(std::memory_order_relaxed)), capacity, static_cast<size_t>(bucketMask) + 1);
+	Publish(next);
+}
+
+void ConcurrentGrid::Clear()
+{
+	State* next = new State;
+	next->frozen = std::make_unique<Frozen>();
+	next->frozen->offsets.assign(static_cast<size_t>(bucketMask) + 2, 0);
+	next->live = std::make_unique<Live>(0, capacity, static_cast<size_t>(bucketMask) + 1);
+	Publish(next);
+}
+
+void ConcurrentGrid::Publish(State* next)
+{
+	//Readers that entered before the epoch is advanced may still hold the old state, later ones load the new one
+	State* old = state.exchange(next);
+	retired.emplace_back(epoch.fetch_add(1), old);
+	Reclaim();
+}
+
+void ConcurrentGrid::Reclaim()
+{
+	uint64_t oldest = UINT64_MAX;
+	for (unsigned i = 0; i < readerCount; i++)
+	{
+		const uint64_t entered = readers[i].load();
+		if (entered != 0) oldest = std::min(oldest, entered);
+	}
+
+	size_t kept = 0;
+	for (const std::pair<uint64_t, State*>& old : retired)
+	{
+		if (old.first < oldest) delete old.second;
+		else retired[kept++] = old;
+	}
+	retired.resize(kept);
+}
+
+size_t ConcurrentGrid::Count() const
+{
+	const Pin pin(*this);
+	return pin.state->frozen->ids.size() + pin.state->live->reserved.load(std::memory_order_relaxed);
+}
+
+size_t ConcurrentGrid::FrozenCount() const
+{
+	const Pin pin(*this);
+	return pin.state->frozen->ids.size();
+}
+
+size_t ConcurrentGrid::PendingReclaim() const
+{
+	return retired.size();
+}
+
+float ConcurrentGrid::CellSize() const
+{
+	return cellSize;
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include "Vector.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+//Hashed uniform grid of points that many threads can insert into at once without locks
+//Inserting threads reserve storage slots with one atomic add and push them onto the list of their hash bucket with compare and swap
+//Freeze compacts everything inserted so far into contiguous per bucket arrays for query phases, readers running at the same time keep the layout they started with
+//Layouts replaced by Freeze and Clear are freed with epoch based reclamation once no reader can still see them
+class ConcurrentGrid
+{
+public:
+	struct Hit
+	{
+		uint32_t id;
+		Vector3 point;
+	};
+
+	static constexpr uint32_t invalid = 0xFFFFFFFF;
+
+	//capacity is the number of points that can be inserted between two Freeze calls, bucketCount is rounded up to a power of two
+	//maxReaders is the number of queries that can run at once, further queries wait for a free slot
+	explicit ConcurrentGrid(float cellSize, size_t capacity = 1 << 20, uint32_t bucketCount = 1 << 16, unsigned maxReaders = 64);
+
+	//Caution: No query may run while the grid is destroyed !
+	~ConcurrentGrid();
+
+	ConcurrentGrid(const ConcurrentGrid&) = delete;
+	ConcurrentGrid& operator=(const ConcurrentGrid&) = delete;
+
+	//Inserts a point and returns its id, or invalid when capacity is exhausted. Safe to call from many threads at once
+	uint32_t Insert(const Vector3& point);
+
+	//Inserts many points with a single reservation, ids are consecutive starting at the returned one
+	//Returns invalid and inserts nothing when they do not fit
+	uint32_t Insert(const Vector3* points, size_t count);
+
+	//Appends points within radius of center, safe to call while other threads insert
+	//Points whose insertion has not completed yet may be missed
+	void Query(std::vector<Hit>& hits, const Vector3& center, float radius) const;
+
+	//Moves every inserted point into the read optimized layout, ids do not change
+	//Caution: No insert may run during Freeze, queries may !
+	void Freeze();
+
+	//Removes every point, ids start from zero again
+	//Caution: No insert may run during Clear, queries may !
+	void Clear();
+
+	//Frees replaced layouts that no reader can see anymore, Freeze and Clear call it too
+	//Caution: Must not run at the same time as Freeze or Clear !
+	void Reclaim();
+
+	//Returns number of points, including ones whose insertion is still in progress
+	[[nodiscard]]
+	size_t Count() const;
+
+	//Returns number of points in the read optimized layout
+	[[nodiscard]]
+	size_t FrozenCount() const;
+
+	//Returns number of replaced layouts that still wait for readers to finish
+	[[nodiscard]]
+	size_t PendingReclaim() const;
+
+	[[nodiscard]]
+	float CellSize() const;
+
+private:
+	struct Live;
+	struct Frozen;
+	struct State;
+	class Pin;
+
+	[[nodiscard]]
+	uint32_t Bucket(int64_t x, int64_t y, int64_t z) const;
+	[[nodiscard]]
+	uint32_t Bucket(const Vector3& point) const;
+	void Cell(int64_t& x, int64_t& y, int64_t& z, const Vector3& point) const;
+
+	void Publish(State* next);
+
+	float cellSize;
+	double inverseCellSize;
+	size_t capacity;
+	uint32_t bucketMask;
+	unsigned readerCount;
+
+	std::atomic<State*> state;
+	std::atomic<uint64_t> epoch;
+	//Epoch each reader entered with, zero for free slots
+	std::unique_ptr<std::atomic<uint64_t>[]> readers;
+	//States replaced at the given epoch
+	std::vector<std::pair<uint64_t, State*>> retired;
+};
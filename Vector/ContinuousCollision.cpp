@@ -0,0 +1,406 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: http://www.viva64.com
+
+#include "ContinuousCollision.h"
+#include "ClosestPoint.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define CONTINUOUSCOLLISION_SSE
+#endif
+
+ContinuousCollision::Triangle::Triangle(const Vector3& a, const Vector3& b, const Vector3& c) : a(a), b(b), c(c)
+{
+	const Vector3 cross = Vector3::Cross(b - a, c - a);
+	const float length = cross.Magnitude();
+	normal = length > 0 ? cross / length : Vector3::zero;
+	offset = Vector3::Dot(normal, a);
+}
+
+//Barycentric test on the plane of the triangle, edges count as inside
+static bool InsideTriangle(const Vector3& point, const Vector3& a, const Vector3& b, const Vector3& c)
+{
+	const Vector3 ab = b - a;
+	const Vector3 ac = c - a;
+	const Vector3 ap = point - a;
+	const double d00 = Vector3::Dot(ab, ab), d01 = Vector3::Dot(ab, ac), d11 = Vector3::Dot(ac, ac);
+	const double d20 = Vector3::Dot(ap, ab), d21 = Vector3::Dot(ap, ac);
+	const double denominator = d00 * d11 - d01 * d01;
+	if (denominator <= 0) return false;
+
+	const double tolerance = 1e-5 * denominator;
+	const double v = d11 * d20 - d01 * d21;
+	const double w = d00 * d21 - d01 * d20;
+	return v >= -tolerance && w >= -tolerance && v + w <= denominator + tolerance;
+}
+
+//Lowest root of a t^2 + b t + c = 0 in [0, maxTime]
+static bool LowestRoot(float& root, const float a, const float b, const float c, const float maxTime)
+{
+	if (a == 0) return false;
+
+	const float discriminant = b * b - 4 * a * c;
+	if (discriminant < 0) return false;
+
+	const float squareRoot = sqrt(discriminant);
+	float first = (-b - squareRoot) / (2 * a);
+	float second = (-b + squareRoot) / (2 * a);
+	if (first > second) std::swap(first, second);
+
+	if (first >= 0 && first <= maxTime) root = first;
+	else if (second >= 0 && second <= maxTime) root = second;
+	else return false;
+	return true;
+}
+
+//Swept sphere against one triangle, only contacts up to maxTime count
+static bool SweepSphere(ContinuousCollision::Contact& contact, const Vector3& start, const Vector3& end, const float radius, const ContinuousCollision::Triangle& triangle, const float maxTime)
+{
+	Vector3 closest;
+	const float sqrDistance = ClosestPoint::PointTriangle(closest, start, triangle.a, triangle.b, triangle.c);
+	if (sqrDistance <= radius * radius)
+	{
+		const Vector3 away = start - closest;
+		const float length = sqrt(sqrDistance);
+		contact.time = 0;
+		contact.point = closest;
+		contact.normal = length > 0 ? away / length : triangle.normal;
+		return true;
+	}
+
+	const Vector3 motion = end - start;
+
+	//Touching the face first is the earliest possible contact, since every other contact needs the sphere to reach the plane too
+	const float distance = Vector3::Dot(triangle.normal, start) - triangle.offset;
+	const float speed = Vector3::Dot(triangle.normal, motion);
+	const float side = distance >= 0 ? 1.0f : -1.0f;
+	if (fabs(distance) >= radius && speed * side < 0)
+	{
+		const float time = (side * radius - distance) / speed;
+		if (time > maxTime) return false;
+
+		const Vector3 point = start + motion * time - triangle.normal * (side * radius);
+		if (InsideTriangle(point, triangle.a, triangle.b, triangle.c))
+		{
+			contact.time = time;
+			contact.point = point;
+			contact.normal = triangle.normal * side;
+			return true;
+		}
+	}
+
+	//Vertices and edges, from Fauerby's "Improved Collision detection and Response"
+	float best = maxTime;
+	bool found = false;
+	const float motionLength = Vector3::Dot(motion, motion);
+	const Vector3* vertices[3] = { &triangle.a, &triangle.b, &triangle.c };
+	for (int i = 0; i < 3; i++)
+	{
+		const Vector3& vertex = *vertices[i];
+		float time;
+		if (!LowestRoot(time, motionLength, 2 * Vector3::Dot(motion, start - vertex), (start - vertex).SqrMagnitude() - radius * radius, best)) continue;
+
+		best = time;
+		contact.point = vertex;
+		found = true;
+	}
+
+	for (int i = 0; i < 3; i++)
+	{
+		const Vector3& from = *vertices[i];
+		const Vector3 edge = *vertices[(i + 1) % 3] - from;
+		const Vector3 toVertex = from - start;
+		const float edgeLength = Vector3::Dot(edge, edge);
+		const float edgeMotion = Vector3::Dot(edge, motion);
+		const float edgeToVertex = Vector3::Dot(edge, toVertex);
+
+		float time;
+		const float a = edgeLength * -motionLength + edgeMotion * edgeMotion;
+		const float b = edgeLength * (2 * Vector3::Dot(motion, toVertex)) - 2 * edgeMotion * edgeToVertex;
+		const float c = edgeLength * (radius * radius - toVertex.SqrMagnitude()) + edgeToVertex * edgeToVertex;
+		if (edgeLength == 0 || !LowestRoot(time, a, b, c, best)) continue;
+
+		//Contact must be within the edge, beyond it the vertex tests apply
+		const float along = (edgeMotion * time - edgeToVertex) / edgeLength;
+		if (along < 0 || along > 1) continue;
+
+		best = time;
+		contact.point = from + edge * along;
+		found = true;
+	}
+
+	if (!found) return false;
+
+	contact.time = best;
+	contact.normal = (start + motion * best - contact.point).Normalize();
+	return true;
+}
+
+bool ContinuousCollision::SphereTriangle(Contact& contact, const Vector3& start, const Vector3& end, const float radius, const Vector3& a, const Vector3& b, const Vector3& c)
+{
+	return SweepSphere(contact, start, end, radius, Triangle(a, b, c), 1);
+}
+
+bool ContinuousCollision::SphereTriangles(Contact& contact, uint32_t& triangle, const Vector3& start, const Vector3& end, const float radius, const Triangle* triangles, const size_t count)
+{
+	float best = 1;
+	bool found = false;
+	const auto test = [&](const size_t i)
+	{
+		Contact candidate;
+		if (!SweepSphere(candidate, start, end, radius, triangles[i], best)) return;
+		if (found && candidate.time >= contact.time) return;
+
+		contact = candidate;
+		triangle = static_cast<uint32_t>(i);
+		best = candidate.time;
+		found = true;
+	};
+
+	size_t i = 0;
+
+#ifdef CONTINUOUSCOLLISION_SSE
+	//Signed distances of both ends of the sweep to four planes, triangles the sphere stays on one side of are skipped
+	//Degenerate triangles have zero normal and distance, so they are never skipped here
+	const __m128 radius4 = _mm_set1_ps(radius);
+	const __m128 negativeRadius4 = _mm_set1_ps(-radius);
+	for (; i + 4 <= count; i += 4)
+	{
+		const Triangle* t = triangles + i;
+		const __m128 nx = _mm_setr_ps(t[0].normal.x, t[1].normal.x, t[2].normal.x, t[3].normal.x);
+		const __m128 ny = _mm_setr_ps(t[0].normal.y, t[1].normal.y, t[2].normal.y, t[3].normal.y);
+		const __m128 nz = _mm_setr_ps(t[0].normal.z, t[1].normal.z, t[2].normal.z, t[3].normal.z);
+		const __m128 offset = _mm_setr_ps(t[0].offset, t[1].offset, t[2].offset, t[3].offset);
+
+		const __m128 startDistance = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, _mm_set1_ps(start.x)), _mm_mul_ps(ny, _mm_set1_ps(start.y))), _mm_mul_ps(nz, _mm_set1_ps(start.z))), offset);
+		const __m128 endDistance = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, _mm_set1_ps(end.x)), _mm_mul_ps(ny, _mm_set1_ps(end.y))), _mm_mul_ps(nz, _mm_set1_ps(end.z))), offset);
+		const __m128 above = _mm_and_ps(_mm_cmpgt_ps(startDistance, radius4), _mm_cmpgt_ps(endDistance, radius4));
+		const __m128 below = _mm_and_ps(_mm_cmplt_ps(startDistance, negativeRadius4), _mm_cmplt_ps(endDistance, negativeRadius4));
+
+		const int skipped = _mm_movemask_ps(_mm_or_ps(above, below));
+		if (skipped == 0xF) continue;
+
+		for (int lane = 0; lane < 4; lane++)
+			if (!(skipped & (1 << lane))) test(i + lane);
+	}
+#endif
+
+	for (; i < count; i++)
+		test(i);
+
+	return found;
+}
+
+//Roots of c[3] t^3 + c[2] t^2 + c[1] t + c[0] in [0, 1] in increasing order, found by bisection between the extrema
+static int CubicRoots(const double c[4], double roots[3])
+{
+	const auto value = [c](const double t) { return ((c[3] * t + c[2]) * t + c[1]) * t + c[0]; };
+
+	//Extrema split [0, 1] into ranges where the polynomial is monotonic
+	double bounds[4] = { 0, 0, 0, 0 };
+	int boundCount = 0;
+	bounds[boundCount++] = 0;
+	const double a = 3 * c[3], b = 2 * c[2];
+	if (a != 0)
+	{
+		const double discriminant = b * b - 4 * a * c[1];
+		if (discriminant > 0)
+		{
+			const double squareRoot = sqrt(discriminant);
+			double first = (-b - squareRoot) / (2 * a);
+			double second = (-b + squareRoot) / (2 * a);
+			if (first > second) std::swap(first, second);
+			if (first > 0 && first < 1) bounds[boundCount++] = first;
+			if (second > 0 && second < 1) bounds[boundCount++] = second;
+		}
+	}
+	else if (b != 0)
+	{
+		const double extremum = -c[1] / b;
+		if (extremum > 0 && extremum < 1) bounds[boundCount++] = extremum;
+	}
+	bounds[boundCount++] = 1;
+
+	int count = 0;
+	for (int i = 0; i + 1 < boundCount; i++)
+	{
+		double low = bounds[i], high = bounds[i + 1];
+		double lowValue = value(low);
+		const double highValue = value(high);
+		if (lowValue == 0)
+		{
+			if (count == 0 || roots[count - 1] != low) roots[count++] = low;
+			continue;
+		}
+		if (highValue == 0 || (lowValue < 0) == (highValue < 0)) continue;
+
+		for (int iteration = 0; iteration < 64; iteration++)
+		{
+			const double middle = (low + high) * 0.5;
+			const double middleValue = value(middle);
+			if ((middleValue < 0) == (lowValue < 0))
+			{
+				low = middle;
+				lowValue = middleValue;
+			}
+			else
+			{
+				high = middle;
+			}
+		}
+		roots[count++] = (low + high) * 0.5;
+	}
+
+	if (value(1) == 0 && (count == 0 || roots[count - 1] != 1)) roots[count++] = 1;
+	return count;
+}
+
+//Point that moves in the plane of the triangle enters it where it crosses one of the moving edges, or is inside from the start
+//Crossing edge u v is where (v - u) x (p - u) . planeNormal = 0, both factors are linear in time so this is a quadratic
+static bool InPlaneContact(ContinuousCollision::Contact& contact, const Vector3& start, const Vector3& end, const Vector3 (&from)[3], const Vector3 (&to)[3], const Vector3& planeNormal)
+{
+	//Candidate times with the edge crossed there, -1 for the start
+	double times[7];
+	int edges[7];
+	int count = 0;
+	times[count] = 0;
+	edges[count++] = -1;
+
+	for (int edge = 0; edge < 3; edge++)
+	{
+		const int next = (edge + 1) % 3;
+		const Vector3 e = from[next] - from[edge], w = start - from[edge];
+		const Vector3 de = (to[next] - to[edge]) - e, dw = (end - to[edge]) - w;
+		const double coefficients[4] = {
+			Vector3::Dot(Vector3::Cross(e, w), planeNormal),
+			static_cast<double>(Vector3::Dot(Vector3::Cross(e, dw), planeNormal)) + Vector3::Dot(Vector3::Cross(de, w), planeNormal),
+			Vector3::Dot(Vector3::Cross(de, dw), planeNormal),
+			0 };
+
+		double roots[3];
+		const int rootCount = CubicRoots(coefficients, roots);
+		for (int i = 0; i < rootCount && i < 2; i++)
+		{
+			times[count] = roots[i];
+			edges[count++] = edge;
+		}
+	}
+
+	//Insertion sort, ties keep the start first
+	for (int i = 1; i < count; i++)
+		for (int j = i; j > 0 && times[j] < times[j - 1]; j--)
+		{
+			std::swap(times[j], times[j - 1]);
+			std::swap(edges[j], edges[j - 1]);
+		}
+
+	for (int i = 0; i < count; i++)
+	{
+		const float time = static_cast<float>(times[i]);
+		Vector3 vertices[3];
+		for (int k = 0; k < 3; k++) vertices[k] = Vector3::LerpNoClamp(from[k], to[k], time);
+		const Vector3 point = Vector3::LerpNoClamp(start, end, time);
+		if (!InsideTriangle(point, vertices[0], vertices[1], vertices[2])) continue;
+
+		//Normal of the crossed edge in the plane, pointing away from the triangle towards the side the point came from
+		Vector3 normal;
+		if (edges[i] < 0)
+		{
+			normal = Vector3::Cross(vertices[1] - vertices[0], vertices[2] - vertices[0]).Normalize();
+		}
+		else
+		{
+			const Vector3& u = vertices[edges[i]];
+			const Vector3& v = vertices[(edges[i] + 1) % 3];
+			const Vector3& opposite = vertices[(edges[i] + 2) % 3];
+			normal = Vector3::Cross(v - u, planeNormal).Normalize();
+			if (Vector3::Dot(normal, opposite - u) > 0) normal = normal * -1;
+		}
+
+		contact.time = time;
+		contact.point = point;
+		contact.normal = normal;
+		return true;
+	}
+
+	return false;
+}
+
+bool ContinuousCollision::PointMovingTriangle(Contact& contact, const Vector3& start, const Vector3& end, const Vector3& a0, const Vector3& b0, const Vector3& c0, const Vector3& a1, const Vector3& b1, const Vector3& c1)
+{
+	//Point is on the plane of the triangle when (b - a) x (c - a) . (p - a) = 0, every term is linear in time so this is a cubic
+	const Vector3 e1 = b0 - a0, e2 = c0 - a0, w = start - a0;
+	const Vector3 de1 = (b1 - a1) - e1, de2 = (c1 - a1) - e2, dw = (end - a1) - w;
+	const Vector3 n0 = Vector3::Cross(e1, e2);
+	const Vector3 n1 = Vector3::Cross(e1, de2) + Vector3::Cross(de1, e2);
+	const Vector3 n2 = Vector3::Cross(de1, de2);
+
+	const double coefficients[4] = {
+		Vector3::Dot(n0, w),
+		static_cast<double>(Vector3::Dot(n0, dw)) + Vector3::Dot(n1, w),
+		static_cast<double>(Vector3::Dot(n1, dw)) + Vector3::Dot(n2, w),
+		Vector3::Dot(n2, dw) };
+
+	//Cubic vanishes when the point moves in the plane of the triangle, every time is a root and only the edges tell when the point gets inside
+	const double scale = (static_cast<double>(n0.Magnitude()) + n1.Magnitude() + n2.Magnitude()) * (static_cast<double>(w.Magnitude()) + dw.Magnitude());
+	if (std::fabs(coefficients[0]) <= 1e-6 * scale && std::fabs(coefficients[1]) <= 1e-6 * scale && std::fabs(coefficients[2]) <= 1e-6 * scale && std::fabs(coefficients[3]) <= 1e-6 * scale)
+	{
+		const Vector3 from[3] = { a0, b0, c0 };
+		const Vector3 to[3] = { a1, b1, c1 };
+		return InPlaneContact(contact, start, end, from, to, n0 + n1 * 0.5f + n2 * 0.25f);
+	}
+
+	double roots[3];
+	const int rootCount = CubicRoots(coefficients, roots);
+	for (int i = 0; i < rootCount; i++)
+	{
+		const float time = static_cast<float>(roots[i]);
+		const Vector3 a = Vector3::LerpNoClamp(a0, a1, time);
+		const Vector3 b = Vector3::LerpNoClamp(b0, b1, time);
+		const Vector3 c = Vector3::LerpNoClamp(c0, c1, time);
+		const Vector3 point = Vector3::LerpNoClamp(start, end, time);
+		if (!InsideTriangle(point, a, b, c)) continue;
+
+		//Normal faces the side the point came from, or against the relative motion if it started on the plane
+		Vector3 normal = Vector3::Cross(b - a, c - a).Normalize();
+		const Vector3 relativeMotion = (end - start) - (a1 - a0);
+		if (coefficients[0] < 0 || (coefficients[0] == 0 && Vector3::Dot(normal, relativeMotion) > 0)) normal = normal * -1;
+
+		contact.time = time;
+		contact.point = point;
+		contact.normal = normal;
+		return true;
+	}
+
+	return false;
+}
+
+bool ContinuousCollision::PointMovingTriangles(Contact& contact, uint32_t& triangle, const Vector3& start, const Vector3& end, const Vector3* from, const Vector3* to, const size_t count)
+{
+	const Vector3 sweepMin(std::min(start.x, end.x), std::min(start.y, end.y), std::min(start.z, end.z));
+	const Vector3 sweepMax(std::max(start.x, end.x), std::max(start.y, end.y), std::max(start.z, end.z));
+
+	bool found = false;
+	for (size_t i = 0; i < count; i++)
+	{
+		//Triangle stays inside the box of its six vertices during the step
+		const Vector3* f = from + i * 3;
+		const Vector3* t = to + i * 3;
+		if (std::max({ f[0].x, f[1].x, f[2].x, t[0].x, t[1].x, t[2].x }) < sweepMin.x || std::min({ f[0].x, f[1].x, f[2].x, t[0].x, t[1].x, t[2].x }) > sweepMax.x) continue;
+		if (std::max({ f[0].y, f[1].y, f[2].y, t[0].y, t[1].y, t[2].y }) < sweepMin.y || std::min({ f[0].y, f[1].y, f[2].y, t[0].y, t[1].y, t[2].y }) > sweepMax.y) continue;
+		if (std::max({ f[0].z, f[1].z, f[2].z, t[0].z, t[1].z, t[2].z }) < sweepMin.z || std::min({ f[0].z, f[1].z, f[2].z, t[0].z, t[1].z, t[2].z }) > sweepMax.z) continue;
+
+		Contact candidate;
+		if (!PointMovingTriangle(candidate, start, end, f[0], f[1], f[2], t[0], t[1], t[2])) continue;
+		if (found && candidate.time >= contact.time) continue;
+
+		contact = candidate;
+		triangle = static_cast<uint32_t>(i);
+		found = true;
+	}
+
+	return found;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "Vector.h"
+#include <cstdint>
+
+//Time of impact queries for motion over one step, time goes from 0 at the start of the step to 1 at its end
+//Unlike sampling positions along the step, nothing thin is skipped however far objects move in one step
+struct ContinuousCollision
+{
+	struct Contact
+	{
+		//Time of first contact in [0, 1]
+		float time;
+		Vector3 point;
+		//Points from the triangle towards the moving object
+		Vector3 normal;
+	};
+
+	//Triangle with its plane precomputed for batch queries
+	struct Triangle
+	{
+		Vector3 a;
+		Vector3 b;
+		Vector3 c;
+		//Unit normal, zero for degenerate triangles
+		Vector3 normal;
+		float offset;
+
+		Triangle() : offset(0) { ; }
+
+		Triangle(const Vector3& a, const Vector3& b, const Vector3& c);
+	};
+
+	//Sphere moving from start to end against a static triangle, returns true if they touch during the step
+	//Contact is at time 0 if the sphere already overlaps the triangle
+	static bool SphereTriangle(Contact& contact, const Vector3& start, const Vector3& end, float radius, const Vector3& a, const Vector3& b, const Vector3& c);
+
+	//Finds the earliest contact of one sweep against many triangles, index of the triangle is saved to triangle
+	//Triangles whose planes the sphere stays away from are rejected four at a time before the exact test
+	static bool SphereTriangles(Contact& contact, uint32_t& triangle, const Vector3& start, const Vector3& end, float radius, const Triangle* triangles, size_t count);
+
+	//Point moving from start to end against a triangle whose vertices move linearly from a0,b0,c0 to a1,b1,c1
+	static bool PointMovingTriangle(Contact& contact, const Vector3& start, const Vector3& end, const Vector3& a0, const Vector3& b0, const Vector3& c0, const Vector3& a1, const Vector3& b1, const Vector3& c1);
+
+	//Finds the earliest contact of one moving point against many moving triangles
+	//Every three consecutive vertices of from and to form a triangle at the start and the end of the step
+	static bool PointMovingTriangles(Contact& contact, uint32_t& triangle, const Vector3& start, const Vector3& end, const Vector3* from, const Vector3* to, size_t count);
+};
@@ -0,0 +1,452 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: http://www.viva64.com
+
+#include "ConvexHull.h"
+#include "Parallel.h"
+#include "Predicates.h"
+#include <cmath>
+#include <limits>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define CONVEXHULL_SSE
+#endif
+
+//Smallest number of points handled by one thread when partitioning
+static const size_t parallelChunk = 1 << 15;
+
+//2D points stored as structure of arrays so the farthest point search can run four points at a time
+struct PointSet2D
+{
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<uint32_t> index;
+
+	void Push(const float px, const float py, const uint32_t i)
+	{
+		x.push_back(px);
+		y.push_back(py);
+		index.push_back(i);
+	}
+
+	void Append(const PointSet2D& other)
+	{
+		x.insert(x.end(), other.x.begin(), other.x.end());
+		y.insert(y.end(), other.y.begin(), other.y.end());
+		index.insert(index.end(), other.index.begin(), other.index.end());
+	}
+};
+
+//Collects points of source that are strictly right of line a->b. Source is accessed through get(i, x, y, index)
+template <typename Getter>
+static void PartitionRight(const size_t count, const Getter& get, const Vector2& a, const Vector2& b, PointSet2D& out)
+{
+	std::vector<PointSet2D> parts(Parallel::ChunkCount(count, parallelChunk));
+
+	Parallel::For(count, parallelChunk, [&](const size_t begin, const size_t end, const unsigned chunk)
+	{
+		PointSet2D& part = parts[chunk];
+		for (size_t i = begin; i < end; i++)
+		{
+			float px, py;
+			uint32_t index;
+			get(i, px, py, index);
+			if (Predicates::Orient2D(a, b, Vector2(px, py)) < 0) part.Push(px, py, index);
+		}
+	});
+
+	for (const PointSet2D& part : parts)
+		out.Append(part);
+}
+
+//Returns position of the point farthest to the right of line a->b
+static size_t FarthestRight(const PointSet2D& set, const Vector2& a, const Vector2& b)
+{
+	const float dx = b.x - a.x;
+	const float dy = b.y - a.y;
+	const size_t count = set.x.size();
+
+	//Cross product of (b - a) and (p - a), right side is negative so the farthest point has the smallest value
+	float best = std::numeric_limits<float>::infinity();
+	size_t bestIndex = 0;
+	size_t i = 0;
+
+#ifdef CONVEXHULL_SSE
+	if (count >= 8)
+	{
+		const __m128 vdx = _mm_set1_ps(dx), vdy = _mm_set1_ps(dy);
+		const __m128 vax = _mm_set1_ps(a.x), vay = _mm_set1_ps(a.y);
+		__m128 bestValue = _mm_set1_ps(std::numeric_limits<float>::infinity());
+		__m128i bestLane = _mm_setzero_si128();
+		__m128i lane = _mm_setr_epi32(0, 1, 2, 3);
+		const __m128i four = _mm_set1_epi32(4);
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128 px = _mm_sub_ps(_mm_loadu_ps(set.x.data() + i), vax);
+			const __m128 py = _mm_sub_ps(_mm_loadu_ps(set.y.data() + i), vay);
+			const __m128 value = _mm_sub_ps(_mm_mul_ps(vdx, py), _mm_mul_ps(vdy, px));
+			const __m128i smaller = _mm_castps_si128(_mm_cmplt_ps(value, bestValue));
+			bestValue = _mm_min_ps(value, bestValue);
+			bestLane = _mm_or_si128(_mm_and_si128(smaller, lane), _mm_andnot_si128(smaller, bestLane));
+			lane = _mm_add_epi32(lane, four);
+		}
+
+		float values[4];
+		int32_t lanes[4];
+		_mm_storeu_ps(values, bestValue);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), bestLane);
+		for (int l = 0; l < 4; l++)
+		{
+			if (values[l] < best)
+			{
+				best = values[l];
+				bestIndex = static_cast<size_t>(lanes[l]);
+			}
+		}
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		const float value = dx * (set.y[i] - a.y) - dy * (set.x[i] - a.x);
+		if (value < best)
+		{
+			best = value;
+			bestIndex = i;
+		}
+	}
+
+	return bestIndex;
+}
+
+//Appends hull vertices strictly between a and b in counter clockwise order, set holds the points right of a->b
+static void FindHull(const PointSet2D& set, const Vector2& a, const Vector2& b, std::vector<uint32_t>& indices)
+{
+	if (set.x.empty()) return;
+
+	const size_t farthest = FarthestRight(set, a, b);
+	const Vector2 f(set.x[farthest], set.y[farthest]);
+	const uint32_t farthestIndex = set.index[farthest];
+
+	const auto get = [&set](const size_t i, float& px, float& py, uint32_t& index)
+	{
+		px = set.x[i];
+		py = set.y[i];
+		index = set.index[i];
+	};
+
+	//Points inside triangle a,f,b are dropped
+	PointSet2D first, second;
+	PartitionRight(set.x.size(), get, a, f, first);
+	PartitionRight(set.x.size(), get, f, b, second);
+
+	FindHull(first, a, f, indices);
+	indices.push_back(farthestIndex);
+	FindHull(second, f, b, indices);
+}
+
+void ConvexHull::Quickhull(const Vector2* points, const size_t count, std::vector<uint32_t>& indices)
+{
+	indices.clear();
+	if (count == 0) return;
+
+	//Leftmost and rightmost points are always on the hull
+	uint32_t left = 0, right = 0;
+	for (uint32_t i = 1; i < count; i++)
+	{
+		const Vector2& p = points[i];
+		if (p.x < points[left].x || (p.x == points[left].x && p.y < points[left].y)) left = i;
+		if (p.x > points[right].x || (p.x == points[right].x && p.y > points[right].y)) right = i;
+	}
+
+	indices.push_back(left);
+	if (points[left].x == points[right].x && points[left].y == points[right].y) return;
+
+	const auto get = [points](const size_t i, float& px, float& py, uint32_t& index)
+	{
+		px = points[i].x;
+		py = points[i].y;
+		index = static_cast<uint32_t>(i);
+	};
+
+	PointSet2D lower, upper;
+	PartitionRight(count, get, points[left], points[right], lower);
+	PartitionRight(count, get, points[right], points[left], upper);
+
+	FindHull(lower, points[left], points[right], indices);
+	indices.push_back(right);
+	FindHull(upper, points[right], points[left], indices);
+
+	//Farthest point search runs in float, on near ties it can pick a point that ends up collinear or reflex, remove those with exact tests
+	size_t size = 0;
+	for (const uint32_t index : indices)
+	{
+		while (size >= 2 && Predicates::Orient2D(points[indices[size - 2]], points[indices[size - 1]], points[index]) <= 0) size--;
+		indices[size++] = index;
+	}
+	while (size >= 3 && Predicates::Orient2D(points[indices[size - 2]], points[indices[size - 1]], points[indices[0]]) <= 0) size--;
+	indices.resize(size);
+}
+
+//Hull triangle, vertices are counter clockwise seen from outside and neighbor[i] shares edge v[i]->v[i + 1]
+struct HullFace
+{
+	uint32_t v[3];
+	uint32_t neighbor[3];
+	std::vector<uint32_t> outside;
+	uint32_t farthest;
+	double farthestDistance;
+	bool dead;
+};
+
+//Point outside a face, used while merging per thread assignments
+struct Conflict
+{
+	uint32_t face;
+	uint32_t point;
+	double distance;
+};
+
+static double FaceOrient(const HullFace& face, const Vector3* points, const Vector3& p)
+{
+	return Predicates::Orient3D(points[face.v[0]], points[face.v[1]], points[face.v[2]], p);
+}
+
+static void AddConflict(HullFace& face, const uint32_t point, const double distance)
+{
+	if (face.outside.empty() || distance > face.farthestDistance)
+	{
+		face.farthest = point;
+		face.farthestDistance = distance;
+	}
+	face.outside.push_back(point);
+}
+
+//Returns index of edge from->to in face, or 3 if the face does not have it
+static uint32_t EdgeIndex(const HullFace& face, const uint32_t from, const uint32_t to)
+{
+	for (uint32_t i = 0; i < 3; i++)
+		if (face.v[i] == from && face.v[(i + 1) % 3] == to) return i;
+	return 3;
+}
+
+//Finds the initial tetrahedron, returns false if points are coplanar
+static bool InitialSimplex(const Vector3* points, const size_t count, uint32_t simplex[4])
+{
+	uint32_t extremes[6] = {};
+	for (uint32_t i = 1; i < count; i++)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (points[i][axis] < points[extremes[axis * 2]][axis]) extremes[axis * 2] = i;
+			if (points[i][axis] > points[extremes[axis * 2 + 1]][axis]) extremes[axis * 2 + 1] = i;
+		}
+	}
+
+	float best = 0;
+	for (int i = 0; i < 6; i++)
+	{
+		for (int j = i + 1; j < 6; j++)
+		{
+			const float distance = (points[extremes[i]] - points[extremes[j]]).SqrMagnitude();
+			if (distance > best)
+			{
+				best = distance;
+				simplex[0] = extremes[i];
+				simplex[1] = extremes[j];
+			}
+		}
+	}
+	if (best == 0) return false;
+
+	const Vector3 direction = points[simplex[1]] - points[simplex[0]];
+	best = 0;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const float distance = Vector3::Cross(points[i] - points[simplex[0]], direction).SqrMagnitude();
+		if (distance > best)
+		{
+			best = distance;
+			simplex[2] = i;
+		}
+	}
+	if (best == 0) return false;
+
+	const Vector3 normal = Vector3::Cross(direction, points[simplex[2]] - points[simplex[0]]);
+	best = 0;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const float distance = fabs(Vector3::Dot(points[i] - points[simplex[0]], normal));
+		if (distance > best)
+		{
+			best = distance;
+			simplex[3] = i;
+		}
+	}
+
+	return best > 0 && Predicates::Orient3D(points[simplex[0]], points[simplex[1]], points[simplex[2]], points[simplex[3]]) != 0;
+}
+
+bool ConvexHull::Quickhull(const Vector3* points, const size_t count, std::vector<uint32_t>& vertices, std::vector<uint32_t>& triangles)
+{
+	vertices.clear();
+	triangles.clear();
+
+	uint32_t simplex[4];
+	if (count < 4 || !InitialSimplex(points, count, simplex)) return false;
+
+	//Tetrahedron faces, each face is oriented so the remaining vertex is behind it
+	std::vector<HullFace> faces;
+	static const int faceVertices[4][4] = { { 0, 1, 2, 3 }, { 0, 1, 3, 2 }, { 0, 2, 3, 1 }, { 1, 2, 3, 0 } };
+	for (const auto& fv : faceVertices)
+	{
+		HullFace face{ { simplex[fv[0]], simplex[fv[1]], simplex[fv[2]] }, { 0, 0, 0 }, {}, 0, 0, false };
+		if (FaceOrient(face, points, points[simplex[fv[3]]]) > 0) std::swap(face.v[1], face.v[2]);
+		faces.push_back(face);
+	}
+	for (uint32_t f = 0; f < 4; f++)
+		for (uint32_t e = 0; e < 3; e++)
+			for (uint32_t g = 0; g < 4; g++)
+				if (g != f && EdgeIndex(faces[g], faces[f].v[(e + 1) % 3], faces[f].v[e]) < 3) faces[f].neighbor[e] = g;
+
+	//Assign every point to the first face it is in front of
+	std::vector<std::vector<Conflict>> conflicts(Parallel::ChunkCount(count, parallelChunk));
+	Parallel::For(count, parallelChunk, [&](const size_t begin, const size_t end, const unsigned chunk)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			for (uint32_t f = 0; f < 4; f++)
+			{
+				const double distance = FaceOrient(faces[f], points, points[i]);
+				if (distance > 0)
+				{
+					conflicts[chunk].push_back(Conflict{ f, static_cast<uint32_t>(i), distance });
+					break;
+				}
+			}
+		}
+	});
+	for (const auto& chunk : conflicts)
+		for (const Conflict& c : chunk)
+			AddConflict(faces[c.face], c.point, c.distance);
+
+	std::vector<uint32_t> stamp(faces.size(), 0);
+	std::vector<uint32_t> visible;
+	std::vector<uint32_t> orphans;
+	std::vector<std::pair<uint32_t, uint32_t>> horizon;
+	struct Frame { uint32_t face, start, step; };
+	std::vector<Frame> stack;
+	uint32_t iteration = 0;
+
+	//Faces are only appended, a face that has no outside points never gets any, so a single pass processes everything
+	for (uint32_t current = 0; current < faces.size(); current++)
+	{
+		if (faces[current].dead || faces[current].outside.empty()) continue;
+
+		const uint32_t eye = faces[current].farthest;
+		const Vector3& eyePoint = points[eye];
+		iteration += 2;
+		stamp.resize(faces.size(), 0);
+
+		//Depth first walk over visible faces, horizon edges come out in counter clockwise order
+		//stamp == iteration marks visible faces, iteration + 1 marks faces known to be hidden
+		visible.clear();
+		horizon.clear();
+		stamp[current] = iteration;
+		visible.push_back(current);
+		stack.push_back(Frame{ current, 0, 0 });
+		while (!stack.empty())
+		{
+			Frame& frame = stack.back();
+			if (frame.step == 3)
+			{
+				stack.pop_back();
+				continue;
+			}
+			const uint32_t face = frame.face;
+			const uint32_t edge = (frame.start + frame.step++) % 3;
+			const uint32_t next = faces[face].neighbor[edge];
+			if (stamp[next] == iteration) continue;
+
+			if (stamp[next] != iteration + 1 && FaceOrient(faces[next], points, eyePoint) > 0)
+			{
+				stamp[next] = iteration;
+				visible.push_back(next);
+				stack.push_back(Frame{ next, EdgeIndex(faces[next], faces[face].v[(edge + 1) % 3], faces[face].v[edge]), 0 });
+			}
+			else
+			{
+				stamp[next] = iteration + 1;
+				horizon.emplace_back(face, edge);
+			}
+		}
+
+		//Cone of new faces from horizon to eye
+		const uint32_t first = static_cast<uint32_t>(faces.size());
+		const uint32_t horizonCount = static_cast<uint32_t>(horizon.size());
+		for (uint32_t i = 0; i < horizonCount; i++)
+		{
+			const HullFace& old = faces[horizon[i].first];
+			const uint32_t edge = horizon[i].second;
+			const uint32_t a = old.v[edge];
+			const uint32_t b = old.v[(edge + 1) % 3];
+			const uint32_t across = old.neighbor[edge];
+
+			HullFace face{ { a, b, eye }, { across, first + (i + 1) % horizonCount, first + (i + horizonCount - 1) % horizonCount }, {}, 0, 0, false };
+			faces[across].neighbor[EdgeIndex(faces[across], b, a)] = first + i;
+			faces.push_back(face);
+		}
+
+		//Move outside points of removed faces to new faces, points behind every new face are inside the hull now
+		orphans.clear();
+		for (const uint32_t v : visible)
+		{
+			for (const uint32_t point : faces[v].outside)
+				if (point != eye) orphans.push_back(point);
+			std::vector<uint32_t>().swap(faces[v].outside);
+			faces[v].dead = true;
+		}
+
+		//Large cones are reassigned on multiple threads, chunks are merged in order so the result does not depend on the thread count
+		conflicts.resize(Parallel::ChunkCount(orphans.size(), parallelChunk));
+		Parallel::For(orphans.size(), parallelChunk, [&](const size_t begin, const size_t end, const unsigned chunk)
+		{
+			conflicts[chunk].clear();
+			for (size_t i = begin; i < end; i++)
+			{
+				for (uint32_t f = first; f < faces.size(); f++)
+				{
+					const double distance = FaceOrient(faces[f], points, points[orphans[i]]);
+					if (distance > 0)
+					{
+						conflicts[chunk].push_back(Conflict{ f, orphans[i], distance });
+						break;
+					}
+				}
+			}
+		});
+		for (const auto& chunk : conflicts)
+			for (const Conflict& c : chunk)
+				AddConflict(faces[c.face], c.point, c.distance);
+	}
+
+	//Compact output, vertices are numbered in order of first use
+	std::vector<uint32_t> remap(count, std::numeric_limits<uint32_t>::max());
+	for (const HullFace& face : faces)
+	{
+		if (face.dead) continue;
+		for (const uint32_t v : face.v)
+		{
+			if (remap[v] == std::numeric_limits<uint32_t>::max())
+			{
+				remap[v] = static_cast<uint32_t>(vertices.size());
+				vertices.push_back(v);
+			}
+			triangles.push_back(remap[v]);
+		}
+	}
+
+	return true;
+}
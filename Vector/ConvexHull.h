@@ -0,0 +1,19 @@
+#pragma once
+#include "Vector.h"
+#include <cstdint>
+#include <vector>
+
+//Quickhull convex hull for 2D and 3D point sets
+//Orientation tests use Predicates, so collinear and coplanar input can not produce inverted or missing faces
+//Large inputs are partitioned on multiple threads
+//The 2D farthest point search runs four points at a time with SSE, 3D has no SIMD path since every orientation test there is an exact Predicates::Orient3D call
+//3D assigns points to faces on multiple threads at the start and whenever a new cone of faces takes over enough points, the walk over visible faces stays serial
+struct ConvexHull
+{
+	//Computes convex hull of 2D points. Output is indices of hull vertices in counter clockwise order, collinear points on hull edges are excluded
+	static void Quickhull(const Vector2* points, size_t count, std::vector<uint32_t>& indices);
+
+	//Computes convex hull of 3D points, returns false if points are coplanar or fewer than four
+	//vertices is the list of input indices used by the hull, triangles holds three indices into vertices per face, counter clockwise seen from outside
+	static bool Quickhull(const Vector3* points, size_t count, std::vector<uint32_t>& vertices, std::vector<uint32_t>& triangles);
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+//Minimal fork join helper used by the batch algorithms
+struct Parallel
+{
+	//Returns number of hardware threads, at least 1
+	static unsigned ThreadCount()
+	{
+		const unsigned count = std::thread::hardware_concurrency();
+		return count == 0 ? 1 : count;
+	}
+
+	//Returns number of chunks For will split count items into when each chunk has at least minChunk items
+	static unsigned ChunkCount(const size_t count, const size_t minChunk)
+	{
+		const size_t chunks = count / (minChunk == 0 ? 1 : minChunk);
+		return static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(chunks, ThreadCount())));
+	}
+
+	//Splits [0, count) into ChunkCount contiguous ranges and calls function(begin, end, chunk) for each of them
+	//First chunk runs on the calling thread, a single chunk does not start any threads
+	template <typename Function>
+	static void For(const size_t count, const size_t minChunk, Function&& function)
+	{
+		const unsigned chunks = ChunkCount(count, minChunk);
+		const size_t step = (count + chunks - 1) / chunks;
+
+		std::vector<std::thread> threads;
+		threads.reserve(chunks - 1);
+		for (unsigned chunk = 1; chunk < chunks; chunk++)
+		{
+			const size_t begin = std::min(count, chunk * step);
+			const size_t end = std::min(count, begin + step);
+			threads.emplace_back([&function, begin, end, chunk]() { function(begin, end, chunk); });
+		}
+
+		function(0, std::min(count, step), 0u);
+
+		for (std::thread& thread : threads)
+			thread.join();
+	}
+};
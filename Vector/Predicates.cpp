@@ -0,0 +1,136 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: http://www.viva64.com
+
+#include "Predicates.h"
+#include <cmath>
+
+//Error bounds of the double precision filters, from Shewchuk's "Adaptive Precision Floating-Point Arithmetic and Fast Robust Geometric Predicates"
+static const double orient2DBound = 3.3306690738754716e-16;
+static const double orient3DBound = 7.7715611723761027e-16;
+
+//Adds q to a non overlapping expansion without error. Expansion is kept in increasing order of magnitude and zero components are dropped
+static void GrowExpansion(double* expansion, int& length, double q)
+{
+	int out = 0;
+	for (int i = 0; i < length; i++)
+	{
+		const double sum = q + expansion[i];
+		const double virtualB = sum - q;
+		const double error = (q - (sum - virtualB)) + (expansion[i] - virtualB);
+		q = sum;
+		if (error != 0) expansion[out++] = error;
+	}
+	if (q != 0) expansion[out++] = q;
+	length = out;
+}
+
+static double EstimateExpansion(const double* expansion, const int length)
+{
+	double sum = 0;
+	for (int i = 0; i < length; i++)
+		sum += expansion[i];
+	return sum;
+}
+
+double Predicates::Orient2D(const Vector2& a, const Vector2& b, const Vector2& c)
+{
+	const double left = (static_cast<double>(a.x) - c.x) * (static_cast<double>(b.y) - c.y);
+	const double right = (static_cast<double>(a.y) - c.y) * (static_cast<double>(b.x) - c.x);
+	const double det = left - right;
+
+	if (fabs(det) > orient2DBound * (fabs(left) + fabs(right))) return det;
+
+	//Product of two floats is exact in double, so the expanded determinant is a sum of six exact terms
+	double expansion[12];
+	int length = 0;
+	GrowExpansion(expansion, length, static_cast<double>(a.x) * b.y);
+	GrowExpansion(expansion, length, -static_cast<double>(a.x) * c.y);
+	GrowExpansion(expansion, length, -static_cast<double>(b.x) * a.y);
+	GrowExpansion(expansion, length, static_cast<double>(b.x) * c.y);
+	GrowExpansion(expansion, length, static_cast<double>(c.x) * a.y);
+	GrowExpansion(expansion, length, -static_cast<double>(c.x) * b.y);
+
+	return EstimateExpansion(expansion, length);
+}
+
+double Predicates::Cross(const Vector2& a0, const Vector2& a1, const Vector2& b0, const Vector2& b1)
+{
+	const double left = (static_cast<double>(a1.x) - a0.x) * (static_cast<double>(b1.y) - b0.y);
+	const double right = (static_cast<double>(a1.y) - a0.y) * (static_cast<double>(b1.x) - b0.x);
+	const double det = left - right;
+
+	if (fabs(det) > orient2DBound * (fabs(left) + fabs(right))) return det;
+
+	double expansion[16];
+	int length = 0;
+	GrowExpansion(expansion, length, static_cast<double>(a1.x) * b1.y);
+	GrowExpansion(expansion, length, -static_cast<double>(a1.x) * b0.y);
+	GrowExpansion(expansion, length, -static_cast<double>(a0.x) * b1.y);
+	GrowExpansion(expansion, length, static_cast<double>(a0.x) * b0.y);
+	GrowExpansion(expansion, length, -static_cast<double>(a1.y) * b1.x);
+	GrowExpansion(expansion, length, static_cast<double>(a1.y) * b0.x);
+	GrowExpansion(expansion, length, static_cast<double>(a0.y) * b1.x);
+	GrowExpansion(expansion, length, -static_cast<double>(a0.y) * b0.x);
+
+	return EstimateExpansion(expansion, length);
+}
+
+double Predicates::Orient3D(const Vector3& a, const Vector3& b, const Vector3& c, const Vector3& d)
+{
+	const double ux = static_cast<double>(b.x) - a.x, uy = static_cast<double>(b.y) - a.y, uz = static_cast<double>(b.z) - a.z;
+	const double vx = static_cast<double>(c.x) - a.x, vy = static_cast<double>(c.y) - a.y, vz = static_cast<double>(c.z) - a.z;
+	const double wx = static_cast<double>(d.x) - a.x, wy = static_cast<double>(d.y) - a.y, wz = static_cast<double>(d.z) - a.z;
+
+	const double vywz = vy * wz, vzwy = vz * wy;
+	const double vzwx = vz * wx, vxwz = vx * wz;
+	const double vxwy = vx * wy, vywx = vy * wx;
+
+	const double det = ux * (vywz - vzwy) + uy * (vzwx - vxwz) + uz * (vxwy - vywx);
+	const double permanent = fabs(ux) * (fabs(vywz) + fabs(vzwy)) + fabs(uy) * (fabs(vzwx) + fabs(vxwz)) + fabs(uz) * (fabs(vxwy) + fabs(vywx));
+
+	if (fabs(det) > orient3DBound * permanent) return det;
+
+	//Exact fallback, the result equals minus the 4x4 determinant with rows (a,1), (b,1), (c,1), (d,1)
+	//Every term is a product of three floats, split into two doubles with a fused multiply add
+	const float rows[4][3] = { { a.x, a.y, a.z }, { b.x, b.y, b.z }, { c.x, c.y, c.z }, { d.x, d.y, d.z } };
+	static const int permutations[24][4] = {
+		{0,1,2,3},{0,1,3,2},{0,2,1,3},{0,2,3,1},{0,3,1,2},{0,3,2,1},
+		{1,0,2,3},{1,0,3,2},{1,2,0,3},{1,2,3,0},{1,3,0,2},{1,3,2,0},
+		{2,0,1,3},{2,0,3,1},{2,1,0,3},{2,1,3,0},{2,3,0,1},{2,3,1,0},
+		{3,0,1,2},{3,0,2,1},{3,1,0,2},{3,1,2,0},{3,2,0,1},{3,2,1,0} };
+
+	double expansion[96];
+	int length = 0;
+
+	for (const auto& permutation : permutations)
+	{
+		int inversions = 0;
+		for (int i = 0; i < 4; i++)
+			for (int j = i + 1; j < 4; j++)
+				if (permutation[i] > permutation[j]) inversions++;
+
+		//Column 3 is the constant 1 column, the row that picks it does not contribute to the product
+		double product = 1;
+		int factors = 0;
+		for (int row = 0; row < 4; row++)
+		{
+			if (permutation[row] == 3) continue;
+			if (factors == 2)
+			{
+				const double high = product * rows[row][permutation[row]];
+				const double low = std::fma(product, static_cast<double>(rows[row][permutation[row]]), -high);
+				const double sign = inversions % 2 ? 1.0 : -1.0;
+				GrowExpansion(expansion, length, sign * high);
+				GrowExpansion(expansion, length, sign * low);
+			}
+			else
+			{
+				product *= rows[row][permutation[row]];
+			}
+			factors++;
+		}
+	}
+
+	return EstimateExpansion(expansion, length);
+}
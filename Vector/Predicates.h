@@ -0,0 +1,16 @@
+#pragma once
+#include "Vector.h"
+
+//Robust orientation predicates for float coordinates
+//Results are computed in double precision and fall back to exact arithmetic when the sign can not be trusted, so the sign is always exact
+struct Predicates
+{
+	//Returns positive value if a,b,c are in counter clockwise order, negative if clockwise and zero if they are collinear
+	static double Orient2D(const Vector2& a, const Vector2& b, const Vector2& c);
+
+	//Returns positive value if direction b1 - b0 is counter clockwise from a1 - a0, negative if clockwise and zero if they are parallel
+	static double Cross(const Vector2& a0, const Vector2& a1, const Vector2& b0, const Vector2& b1);
+
+	//Returns positive value if d is on the side of plane a,b,c that Cross(b - a, c - a) points to, negative on the other side and zero if coplanar
+	static double Orient3D(const Vector3& a, const Vector3& b, const Vector3& c, const Vector3& d);
+};
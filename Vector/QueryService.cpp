@@ -0,0 +1,232 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: http://www.viva64.com
+
+#include "QueryService.h"
+#include <algorithm>
+#include <chrono>
+
+typedef std::chrono::steady_clock Clock;
+
+static double Milliseconds(const Clock::time_point from, const Clock::time_point to)
+{
+	return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+//IntersectionQuery
+IntersectionQuery IntersectionQuery::Plane(const Vector3& direction, const Vector3& origin, const Vector3& normal, const Vector3& plane)
+{
+	return IntersectionQuery{ Type::Plane, origin, direction, normal, plane, Vector3() };
+}
+
+IntersectionQuery IntersectionQuery::Triangle(const Vector3& direction, const Vector3& origin, const Vector3& a, const Vector3& b, const Vector3& c)
+{
+	return IntersectionQuery{ Type::Triangle, origin, direction, a, b, c };
+}
+
+bool IntersectionQuery::Run(Vector3& intersection) const
+{
+	if (type == Type::Plane)
+		return Vector3::LinePlaneIntersection(intersection, direction, origin, a, b);
+
+	return Vector3::LineTriangleIntersection(intersection, direction, origin, a, b, c);
+}
+
+//QueryTicket
+void QueryTicket::Cancel()
+{
+	if (cancelled) cancelled->store(true);
+}
+
+bool QueryTicket::Ready() const
+{
+	return future.valid() && future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+BatchResult QueryTicket::Get()
+{
+	return future.get();
+}
+
+std::future<BatchResult>& QueryTicket::Future()
+{
+	return future;
+}
+
+//QueryService
+struct QueryService::Batch
+{
+	std::vector<IntersectionQuery> queries;
+	BatchResult result;
+	std::promise<BatchResult> promise;
+	std::shared_ptr<std::atomic<bool>> cancelled;
+	std::atomic<size_t> remaining{ 0 };
+	std::atomic<bool> started{ false };
+	Clock::time_point submitted;
+};
+
+QueryService::QueryService(const unsigned threads, const size_t queueCapacity, const size_t chunkSize)
+	: capacity(std::max<size_t>(1, queueCapacity)), chunkSize(std::max<size_t>(1, chunkSize))
+{
+	const unsigned count = std::max(1u, threads);
+	this->threads.reserve(count);
+	for (unsigned i = 0; i < count; i++)
+		this->threads.emplace_back(&QueryService::Worker, this);
+}
+
+QueryService::~QueryService()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+		for (const Chunk& chunk : queue)
+			chunk.batch->cancelled->store(true);
+	}
+	notEmpty.notify_all();
+	notFull.notify_all();
+
+	for (std::thread& thread : threads)
+		thread.join();
+}
+
+QueryTicket QueryService::CreateBatch(std::vector<IntersectionQuery>&& queries, std::shared_ptr<Batch>& batch) const
+{
+	batch = std::make_shared<Batch>();
+	batch->queries = std::move(queries);
+	batch->result.results.assign(batch->queries.size(), IntersectionResult{ false, Vector3() });
+	batch->cancelled = std::make_shared<std::atomic<bool>>(false);
+	batch->remaining = (batch->queries.size() + chunkSize - 1) / chunkSize;
+	batch->submitted = Clock::now();
+
+	QueryTicket ticket;
+	ticket.future = batch->promise.get_future();
+	ticket.cancelled = batch->cancelled;
+	return ticket;
+}
+
+QueryTicket QueryService::Submit(std::vector<IntersectionQuery> queries)
+{
+	std::shared_ptr<Batch> batch;
+	QueryTicket ticket = CreateBatch(std::move(queries), batch);
+	Enqueue(batch);
+	return ticket;
+}
+
+bool QueryService::TrySubmit(std::vector<IntersectionQuery>& queries, QueryTicket& ticket)
+{
+	const size_t chunks = (queries.size() + chunkSize - 1) / chunkSize;
+	if (chunks > capacity) return false;
+
+	std::shared_ptr<Batch> batch;
+	QueryTicket created = CreateBatch(std::move(queries), batch);
+
+	//Capacity check and pushing every chunk happen under one lock, so other submitters cannot fill the queue in between and nothing waits on notFull
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (stopping || queue.size() + chunks > capacity)
+		{
+			queries = std::move(batch->queries);
+			return false;
+		}
+
+		statistics.submitted++;
+		for (size_t begin = 0; begin < batch->queries.size(); begin += chunkSize)
+			queue.push_back(Chunk{ batch, begin, std::min(begin + chunkSize, batch->queries.size()) });
+	}
+
+	if (chunks == 0) Finish(*batch);
+	else if (chunks == 1) notEmpty.notify_one();
+	else notEmpty.notify_all();
+
+	ticket = std::move(created);
+	return true;
+}
+
+QueryService::Statistics QueryService::GetStatistics() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return statistics;
+}
+
+void QueryService::Enqueue(const std::shared_ptr<Batch>& batch)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		statistics.submitted++;
+	}
+
+	if (batch->queries.empty())
+	{
+		Finish(*batch);
+		return;
+	}
+
+	for (size_t begin = 0; begin < batch->queries.size(); begin += chunkSize)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		notFull.wait(lock, [this]() { return queue.size() < capacity || stopping; });
+		if (stopping) batch->cancelled->store(true);
+		queue.push_back(Chunk{ batch, begin, std::min(begin + chunkSize, batch->queries.size()) });
+		lock.unlock();
+		notEmpty.notify_one();
+	}
+}
+
+void QueryService::Worker()
+{
+	for (;;)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		notEmpty.wait(lock, [this]() { return !queue.empty() || stopping; });
+		if (queue.empty()) return;
+
+		const Chunk chunk = std::move(queue.front());
+		queue.pop_front();
+		lock.unlock();
+		notFull.notify_one();
+
+		RunChunk(chunk);
+	}
+}
+
+void QueryService::RunChunk(const Chunk& chunk)
+{
+	Batch& batch = *chunk.batch;
+
+	bool expected = false;
+	if (batch.started.compare_exchange_strong(expected, true))
+		batch.result.queueMilliseconds = Milliseconds(batch.submitted, Clock::now());
+
+	for (size_t i = chunk.begin; i < chunk.end; i++)
+	{
+		//Cancellation is checked when the chunk starts and every 64 queries after, to keep the flag off the hot path
+		if (((i - chunk.begin) & 63) == 0 && batch.cancelled->load(std::memory_order_relaxed)) break;
+
+		IntersectionResult& result = batch.result.results[i];
+		result.hit = batch.queries[i].Run(result.point);
+	}
+
+	if (batch.remaining.fetch_sub(1) == 1) Finish(batch);
+}
+
+void QueryService::Finish(Batch& batch)
+{
+	batch.result.cancelled = batch.cancelled->load();
+	batch.result.latencyMilliseconds = Milliseconds(batch.submitted, Clock::now());
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (batch.result.cancelled)
+		{
+			statistics.cancelled++;
+		}
+		else
+		{
+			statistics.completed++;
+			statistics.meanLatencyMilliseconds += (batch.result.latencyMilliseconds - statistics.meanLatencyMilliseconds) / static_cast<double>(statistics.completed);
+			statistics.maxLatencyMilliseconds = std::max(statistics.maxLatencyMilliseconds, batch.result.latencyMilliseconds);
+		}
+	}
+
+	batch.promise.set_value(std::move(batch.result));
+}
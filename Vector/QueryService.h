@@ -0,0 +1,132 @@
+#pragma once
+#include "Vector.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Single line intersection query, runs LinePlaneIntersection or LineTriangleIntersection
+//Caution: Make sure direction vector is normalized !
+struct IntersectionQuery
+{
+	enum class Type : uint8_t { Plane, Triangle };
+
+	Type type;
+	Vector3 origin;
+	Vector3 direction;
+	//Plane queries use a as plane normal and b as a point on the plane, triangle queries use a,b,c as vertices
+	Vector3 a;
+	Vector3 b;
+	Vector3 c;
+
+	static IntersectionQuery Plane(const Vector3& direction, const Vector3& origin, const Vector3& normal, const Vector3& plane);
+	static IntersectionQuery Triangle(const Vector3& direction, const Vector3& origin, const Vector3& a, const Vector3& b, const Vector3& c);
+
+	//Runs the query on the calling thread, returns true if there is intersection
+	bool Run(Vector3& intersection) const;
+};
+
+struct IntersectionResult
+{
+	bool hit;
+	Vector3 point;
+};
+
+//Results of a batch, in the same order as the submitted queries
+struct BatchResult
+{
+	std::vector<IntersectionResult> results;
+	//Set when the batch was cancelled, results of skipped queries are left as misses
+	bool cancelled = false;
+	//Time spent waiting in the queue and time from submission to completion
+	double queueMilliseconds = 0;
+	double latencyMilliseconds = 0;
+};
+
+//Handle of a submitted batch
+class QueryTicket
+{
+public:
+	//Requests cancellation, chunks that have not started are skipped and running chunks stop within 64 queries
+	void Cancel();
+
+	//Returns true if the batch has completed
+	[[nodiscard]]
+	bool Ready() const;
+
+	//Blocks until the batch completes and returns its results, can be called once
+	BatchResult Get();
+
+	//Underlying future, for callers that compose their own waiting
+	std::future<BatchResult>& Future();
+
+private:
+	friend class QueryService;
+	std::future<BatchResult> future;
+	std::shared_ptr<std::atomic<bool>> cancelled;
+};
+
+//Runs intersection query batches on a background thread pool
+//Batches are split into chunks that are queued in a bounded queue, so one large batch is worked on by all threads and Submit blocks when the queue is full
+class QueryService
+{
+public:
+	struct Statistics
+	{
+		size_t submitted = 0;
+		size_t completed = 0;
+		size_t cancelled = 0;
+		double meanLatencyMilliseconds = 0;
+		double maxLatencyMilliseconds = 0;
+	};
+
+	//queueCapacity is the number of chunks that can wait in the queue, chunkSize the number of queries in a chunk
+	explicit QueryService(unsigned threads = std::thread::hardware_concurrency(), size_t queueCapacity = 256, size_t chunkSize = 1024);
+
+	//Cancels pending batches and stops the threads
+	~QueryService();
+
+	QueryService(const QueryService&) = delete;
+	QueryService& operator=(const QueryService&) = delete;
+
+	//Submits a batch, blocks while the queue is full
+	QueryTicket Submit(std::vector<IntersectionQuery> queries);
+
+	//Submits a batch only if the whole batch fits in the queue, returns false without blocking otherwise and leaves queries unchanged
+	//Caution: Batches of more than queueCapacity chunks never fit and always return false, submit them with Submit !
+	bool TrySubmit(std::vector<IntersectionQuery>& queries, QueryTicket& ticket);
+
+	[[nodiscard]]
+	Statistics GetStatistics() const;
+
+private:
+	struct Batch;
+
+	struct Chunk
+	{
+		std::shared_ptr<Batch> batch;
+		size_t begin;
+		size_t end;
+	};
+
+	QueryTicket CreateBatch(std::vector<IntersectionQuery>&& queries, std::shared_ptr<Batch>& batch) const;
+	void Enqueue(const std::shared_ptr<Batch>& batch);
+	void Worker();
+	void RunChunk(const Chunk& chunk);
+	void Finish(Batch& batch);
+
+	size_t capacity;
+	size_t chunkSize;
+	bool stopping = false;
+	std::deque<Chunk> queue;
+	mutable std::mutex mutex;
+	std::condition_variable notEmpty;
+	std::condition_variable notFull;
+	std::vector<std::thread> threads;
+	Statistics statistics;
+};
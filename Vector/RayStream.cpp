@@ -0,0 +1,321 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: http://www.viva64.com
+
+#include "RayStream.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define RAYSTREAM_SSE
+#endif
+
+//Spreads the lowest 10 bits of value so that there are two zero bits between each of them
+static uint64_t SpreadBits(uint64_t value)
+{
+	value &= 0x3FF;
+	value = (value | (value << 16)) & 0x30000FF;
+	value = (value | (value << 8)) & 0x300F00F;
+	value = (value | (value << 4)) & 0x30C30C3;
+	value = (value | (value << 2)) & 0x9249249;
+	return value;
+}
+
+float RayStream::Metrics::MeanPacketSize() const
+{
+	return packets == 0 ? 0 : static_cast<float>(rays) / static_cast<float>(packets);
+}
+
+float RayStream::Metrics::RaysPerNodeVisit() const
+{
+	return nodeVisits == 0 ? 0 : static_cast<float>(rayBoxTests) / static_cast<float>(nodeVisits);
+}
+
+RayStream::RayStream(const float cellSize, const uint32_t packetSize) : cellSize(cellSize), packetSize(std::max(1u, packetSize))
+{
+}
+
+uint32_t RayStream::Octant(const Vector3& direction)
+{
+	return (direction.x < 0 ? 1u : 0u) | (direction.y < 0 ? 2u : 0u) | (direction.z < 0 ? 4u : 0u);
+}
+
+void RayStream::Sort(const Vector3* directionArray, const Vector3* originArray, const size_t count)
+{
+	directions = directionArray;
+	origins = originArray;
+	order.resize(count);
+	packets.clear();
+	metrics = Metrics();
+	metrics.rays = count;
+	if (count == 0) return;
+
+	//Cells relative to the lowest cell of the batch, coarsened until every axis fits 10 bits of the Morton code
+	constexpr float limit = 1073741824.0f;
+	std::vector<int64_t> cells(count * 3);
+	int64_t low[3] = { INT64_MAX, INT64_MAX, INT64_MAX };
+	int64_t high[3] = { INT64_MIN, INT64_MIN, INT64_MIN };
+	for (size_t i = 0; i < count; i++)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			const int64_t cell = static_cast<int64_t>(std::floor(std::max(-limit, std::min(limit, originArray[i][axis] / cellSize))));
+			cells[i * 3 + axis] = cell;
+			low[axis] = std::min(low[axis], cell);
+			high[axis] = std::max(high[axis], cell);
+		}
+	}
+
+	int shift = 0;
+	while (((high[0] - low[0]) >> shift) >= 1024 || ((high[1] - low[1]) >> shift) >= 1024 || ((high[2] - low[2]) >> shift) >= 1024)
+		shift++;
+
+	//Octant is the most significant part of the key, so packets never mix octants
+	std::vector<uint64_t> keys(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		const uint64_t x = static_cast<uint64_t>(cells[i * 3] - low[0]) >> shift;
+		const uint64_t y = static_cast<uint64_t>(cells[i * 3 + 1] - low[1]) >> shift;
+		const uint64_t z = static_cast<uint64_t>(cells[i * 3 + 2] - low[2]) >> shift;
+		keys[i] = static_cast<uint64_t>(Octant(directionArray[i])) << 30 | SpreadBits(x) | SpreadBits(y) << 1 | SpreadBits(z) << 2;
+		order[i] = static_cast<uint32_t>(i);
+	}
+
+	//Least significant digit radix sort of the 33 bit keys, three passes of 11 bits
+	std::vector<uint64_t> sortedKeys(count);
+	std::vector<uint32_t> sortedOrder(count);
+	for (int pass = 0; pass < 3; pass++)
+	{
+		const int digitShift = pass * 11;
+		size_t offsets[2049] = {};
+		for (size_t i = 0; i < count; i++)
+			offsets[((keys[i] >> digitShift) & 0x7FF) + 1]++;
+		for (size_t digit = 0; digit < 2048; digit++)
+			offsets[digit + 1] += offsets[digit];
+		for (size_t i = 0; i < count; i++)
+		{
+			const size_t slot = offsets[(keys[i] >> digitShift) & 0x7FF]++;
+			sortedKeys[slot] = keys[i];
+			sortedOrder[slot] = order[i];
+		}
+		keys.swap(sortedKeys);
+		order.swap(sortedOrder);
+	}
+
+	uint32_t begin = 0;
+	for (uint32_t i = 1; i <= count; i++)
+	{
+		if (i < count && i - begin < packetSize && keys[i] >> 30 == keys[begin] >> 30) continue;
+		packets.push_back({ begin, i - begin, static_cast<uint32_t>(keys[begin] >> 30) });
+		begin = i;
+	}
+
+	double stepBefore = 0, stepAfter = 0;
+	size_t changesBefore = 0, changesAfter = 0;
+	for (size_t i = 1; i < count; i++)
+	{
+		stepBefore += Vector3::Distance(originArray[i - 1], originArray[i]);
+		stepAfter += Vector3::Distance(originArray[order[i - 1]], originArray[order[i]]);
+		changesBefore += Octant(directionArray[i - 1]) != Octant(directionArray[i]);
+		changesAfter += Octant(directionArray[order[i - 1]]) != Octant(directionArray[order[i]]);
+	}
+
+	const double pairs = static_cast<double>(std::max<size_t>(1, count - 1));
+	metrics.packets = packets.size();
+	metrics.originStepBefore = static_cast<float>(stepBefore / pairs);
+	metrics.originStepAfter = static_cast<float>(stepAfter / pairs);
+	metrics.octantChangesBefore = static_cast<float>(changesBefore / pairs);
+	metrics.octantChangesAfter = static_cast<float>(changesAfter / pairs);
+}
+
+size_t RayStream::Trace(std::vector<BVH::RaycastHit>& hits, std::vector<uint8_t>& found, const BVH& tree, const Vector3* vertices, const float maxDistance)
+{
+	hits.resize(order.size());
+	found.assign(order.size(), 0);
+
+	constexpr size_t minChunk = 16;
+	std::vector<TraceCounters> chunkCounters(Parallel::ChunkCount(packets.size(), minChunk));
+	Parallel::For(packets.size(), minChunk, [&](const size_t begin, const size_t end, const unsigned chunk)
+	{
+		for (size_t i = begin; i < end; i++)
+			TracePacket(chunkCounters[chunk], hits.data(), found.data(), packets[i], tree, vertices, maxDistance);
+	});
+
+	TraceCounters total;
+	for (const TraceCounters& counters : chunkCounters)
+	{
+		total.nodeVisits += counters.nodeVisits;
+		total.rayBoxTests += counters.rayBoxTests;
+		total.rayBoxHits += counters.rayBoxHits;
+		total.rayTriangleTests += counters.rayTriangleTests;
+		total.hits += counters.hits;
+	}
+
+	metrics.nodeVisits = total.nodeVisits;
+	metrics.rayBoxTests = total.rayBoxTests;
+	metrics.rayTriangleTests = total.rayTriangleTests;
+	metrics.activeFraction = total.rayBoxTests == 0 ? 0 : static_cast<float>(total.rayBoxHits) / static_cast<float>(total.rayBoxTests);
+	return total.hits;
+}
+
+void RayStream::TracePacket(TraceCounters& counters, BVH::RaycastHit* hits, uint8_t* found, const Packet& packet, const BVH& tree, const Vector3* vertices, const float maxDistance) const
+{
+	if (tree.Root() == BVH::invalid) return;
+
+	//Node and the range of the ray list holding the rays that reached it
+	struct Entry
+	{
+		uint32_t node;
+		uint32_t begin;
+		uint32_t count;
+	};
+
+	//Packet rays as structure of arrays, closest is the nearest hit so far and culls boxes behind it
+	thread_local std::vector<float> originX, originY, originZ, inverseX, inverseY, inverseZ, closest;
+	thread_local std::vector<Entry> stack;
+	thread_local std::vector<uint32_t> rays, survivors;
+
+	const uint32_t count = packet.count;
+	for (std::vector<float>* lane : { &originX, &originY, &originZ, &inverseX, &inverseY, &inverseZ, &closest })
+		lane->resize(count);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const uint32_t ray = order[packet.begin + i];
+		originX[i] = origins[ray].x;
+		originY[i] = origins[ray].y;
+		originZ[i] = origins[ray].z;
+		inverseX[i] = 1 / directions[ray].x;
+		inverseY[i] = 1 / directions[ray].y;
+		inverseZ[i] = 1 / directions[ray].z;
+		closest[i] = maxDistance;
+	}
+
+	rays.resize(count);
+	for (uint32_t i = 0; i < count; i++)
+		rays[i] = i;
+	stack.assign(1, { tree.Root(), 0, count });
+
+	const std::vector<BVH::Node>& nodes = tree.Nodes();
+	const std::vector<uint32_t>& triangles = tree.Triangles();
+	while (!stack.empty())
+	{
+		const Entry entry = stack.back();
+		stack.pop_back();
+
+		const BVH::Node& node = nodes[entry.node];
+		counters.nodeVisits++;
+		counters.rayBoxTests += entry.count;
+
+		//Slab test of Bounds::RayIntersection for every ray of the list
+		survivors.clear();
+		const uint32_t* list = rays.data() + entry.begin;
+		uint32_t i = 0;
+
+#ifdef RAYSTREAM_SSE
+		const __m128 minX = _mm_set1_ps(node.bounds.min.x), minY = _mm_set1_ps(node.bounds.min.y), minZ = _mm_set1_ps(node.bounds.min.z);
+		const __m128 maxX = _mm_set1_ps(node.bounds.max.x), maxY = _mm_set1_ps(node.bounds.max.y), maxZ = _mm_set1_ps(node.bounds.max.z);
+		for (; i + 4 <= entry.count; i += 4)
+		{
+			const uint32_t r0 = list[i], r1 = list[i + 1], r2 = list[i + 2], r3 = list[i + 3];
+			__m128 entryDistance = _mm_setzero_ps();
+			__m128 exitDistance = _mm_setr_ps(closest[r0], closest[r1], closest[r2], closest[r3]);
+
+			const auto slab = [&](const __m128 low, const __m128 high, const std::vector<float>& origin, const std::vector<float>& inverse)
+			{
+				const __m128 o = _mm_setr_ps(origin[r0], origin[r1], origin[r2], origin[r3]);
+				const __m128 d = _mm_setr_ps(inverse[r0], inverse[r1], inverse[r2], inverse[r3]);
+				const __m128 nearDistance = _mm_mul_ps(_mm_sub_ps(low, o), d);
+				const __m128 farDistance = _mm_mul_ps(_mm_sub_ps(high, o), d);
+				//Same NaN handling as Bounds::RayIntersection: a ray parallel to the slab with its origin on a plane gives 0 * inf, the swap skips it and the running entry and exit stay
+				//Min and max return their second operand when either one is NaN, so the running values go second
+				const __m128 swap = _mm_cmpgt_ps(nearDistance, farDistance);
+				const __m128 first = _mm_or_ps(_mm_and_ps(swap, farDistance), _mm_andnot_ps(swap, nearDistance));
+				const __m128 second = _mm_or_ps(_mm_and_ps(swap, nearDistance), _mm_andnot_ps(swap, farDistance));
+				entryDistance = _mm_max_ps(first, entryDistance);
+				exitDistance = _mm_min_ps(second, exitDistance);
+			};
+			slab(minX, maxX, originX, inverseX);
+			slab(minY, maxY, originY, inverseY);
+			slab(minZ, maxZ, originZ, inverseZ);
+
+			const int hit = _mm_movemask_ps(_mm_cmple_ps(entryDistance, exitDistance));
+			for (uint32_t lane = 0; lane < 4; lane++)
+				if (hit & (1 << lane)) survivors.push_back(list[i + lane]);
+		}
+#endif
+
+		for (; i < entry.count; i++)
+		{
+			const uint32_t ray = list[i];
+			float distance;
+			const Vector3 origin(originX[ray], originY[ray], originZ[ray]);
+			const Vector3 inverseDirection(inverseX[ray], inverseY[ray], inverseZ[ray]);
+			if (node.bounds.RayIntersection(distance, origin, inverseDirection, closest[ray])) survivors.push_back(ray);
+		}
+
+		counters.rayBoxHits += survivors.size();
+		if (survivors.empty()) continue;
+
+		if (node.count == 0)
+		{
+			//Both children get the same list, it is stored once. Child nearer along the packet octant is visited first so its hits cull the other one
+			const uint32_t begin = static_cast<uint32_t>(rays.size());
+			const uint32_t survivorCount = static_cast<uint32_t>(survivors.size());
+			rays.insert(rays.end(), survivors.begin(), survivors.end());
+			const Vector3 offset = nodes[node.second].bounds.min + nodes[node.second].bounds.max - nodes[node.first].bounds.min - nodes[node.first].bounds.max;
+			const Vector3 signs(packet.octant & 1 ? -1.0f : 1.0f, packet.octant & 2 ? -1.0f : 1.0f, packet.octant & 4 ? -1.0f : 1.0f);
+			const bool firstNearer = Vector3::Dot(offset, signs) >= 0;
+			stack.push_back({ firstNearer ? node.second : node.first, begin, survivorCount });
+			stack.push_back({ firstNearer ? node.first : node.second, begin, survivorCount });
+			continue;
+		}
+
+		//Leaf triangles are loaded once and tested against every surviving ray
+		for (uint32_t t = node.first; t < node.first + node.count; t++)
+		{
+			const uint32_t triangle = triangles[t];
+			const Vector3& a = vertices[triangle * 3];
+			const Vector3& b = vertices[triangle * 3 + 1];
+			const Vector3& c = vertices[triangle * 3 + 2];
+			counters.rayTriangleTests += survivors.size();
+
+			for (const uint32_t ray : survivors)
+			{
+				const uint32_t original = order[packet.begin + ray];
+				const Vector3& direction = directions[original];
+				const Vector3 origin(originX[ray], originY[ray], originZ[ray]);
+				Vector3 point;
+				if (!Vector3::LineTriangleIntersection(point, direction, origin, a, b, c)) continue;
+
+				const float distance = Vector3::Dot(point - origin, direction);
+				if (distance >= closest[ray]) continue;
+
+				closest[ray] = distance;
+				hits[original].point = point;
+				hits[original].distance = distance;
+				hits[original].triangle = triangle;
+				found[original] = 1;
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < count; i++)
+		counters.hits += found[order[packet.begin + i]];
+}
+
+const std::vector<uint32_t>& RayStream::Order() const
+{
+	return order;
+}
+
+const std::vector<RayStream::Packet>& RayStream::Packets() const
+{
+	return packets;
+}
+
+const RayStream::Metrics& RayStream::GetMetrics() const
+{
+	return metrics;
+}
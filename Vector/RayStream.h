@@ -0,0 +1,91 @@
+#pragma once
+#include "BVH.h"
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+//Reorders large incoherent ray batches into coherent packets and traces the packets through a BVH as streams
+//Rays are keyed by direction octant and the Morton code of their quantized origin cell, so a packet holds rays that start close together and go the same general way
+//Each packet is traced as a stream: every node filters the list of rays that reached it, so a node is fetched once for the whole packet instead of once per ray
+//Nodes are visited nearer child first along the packet octant, so hits found early cull boxes behind them for the whole stream
+class RayStream
+{
+public:
+	//Rays [begin, begin + count) of Order(), all with the same direction octant
+	struct Packet
+	{
+		uint32_t begin;
+		uint32_t count;
+		uint32_t octant;
+	};
+
+	struct Metrics
+	{
+		size_t rays = 0;
+		size_t packets = 0;
+		//Mean distance between origins of consecutive rays, in submission order and in sorted order
+		float originStepBefore = 0;
+		float originStepAfter = 0;
+		//Fraction of consecutive rays whose direction octants differ, in submission order and in sorted order
+		float octantChangesBefore = 0;
+		float octantChangesAfter = 0;
+		//Node fetches of the last Trace, one per packet and node instead of one per ray and node
+		size_t nodeVisits = 0;
+		size_t rayBoxTests = 0;
+		size_t rayTriangleTests = 0;
+		//Fraction of ray box tests that hit, the share of lanes doing useful work
+		float activeFraction = 0;
+
+		[[nodiscard]]
+		float MeanPacketSize() const;
+
+		//Ray box tests per node fetch, how many rays share the cost of every node fetch
+		[[nodiscard]]
+		float RaysPerNodeVisit() const;
+	};
+
+	//Origins are quantized to cells of cellSize, packets hold at most packetSize rays
+	explicit RayStream(float cellSize, uint32_t packetSize = 64);
+
+	//Sorts rays and splits them into packets, directions and origins are not copied and must stay alive for Trace
+	//Caution: Make sure direction vectors are normalized !
+	void Sort(const Vector3* directions, const Vector3* origins, size_t count);
+
+	//Traces sorted rays, results are indexed by the original ray index and found[i] is 1 for rays that hit
+	//Returns number of rays that hit
+	size_t Trace(std::vector<BVH::RaycastHit>& hits, std::vector<uint8_t>& found, const BVH& tree, const Vector3* vertices, float maxDistance = std::numeric_limits<float>::infinity());
+
+	//Original ray indices in sorted order
+	[[nodiscard]]
+	const std::vector<uint32_t>& Order() const;
+
+	[[nodiscard]]
+	const std::vector<Packet>& Packets() const;
+
+	[[nodiscard]]
+	const Metrics& GetMetrics() const;
+
+	//Returns octant of a direction, bit 0 set for negative x, bit 1 for negative y and bit 2 for negative z
+	[[nodiscard]]
+	static uint32_t Octant(const Vector3& direction);
+
+private:
+	struct TraceCounters
+	{
+		size_t nodeVisits = 0;
+		size_t rayBoxTests = 0;
+		size_t rayBoxHits = 0;
+		size_t rayTriangleTests = 0;
+		size_t hits = 0;
+	};
+
+	void TracePacket(TraceCounters& counters, BVH::RaycastHit* hits, uint8_t* found, const Packet& packet, const BVH& tree, const Vector3* vertices, float maxDistance) const;
+
+	float cellSize;
+	uint32_t packetSize;
+	const Vector3* directions = nullptr;
+	const Vector3* origins = nullptr;
+	std::vector<uint32_t> order;
+	std::vector<Packet> packets;
+	Metrics metrics;
+};
@@ -0,0 +1,361 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: http://www.viva64.com
+
+#include "SegmentIntersection.h"
+#include "Predicates.h"
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <set>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define SEGMENTINTERSECTION_SSE
+#endif
+
+//Sweep events and intersection points are kept in double, ordered by x then y
+struct SweepPoint
+{
+	double x;
+	double y;
+
+	bool operator < (const SweepPoint& p) const
+	{
+		return x < p.x || (x == p.x && y < p.y);
+	}
+
+	bool operator == (const SweepPoint& p) const
+	{
+		return x == p.x && y == p.y;
+	}
+};
+
+static SweepPoint ToPoint(const Vector2& v)
+{
+	return SweepPoint{ v.x, v.y };
+}
+
+static int Sign(const double value)
+{
+	return (value > 0) - (value < 0);
+}
+
+//Crossing point of two segments known to cross, clamped to their bounds so vertical and horizontal segments keep their exact coordinate
+static SweepPoint CrossingPoint(const Vector2& a0, const Vector2& a1, const Vector2& b0, const Vector2& b1)
+{
+	const double ux = static_cast<double>(a1.x) - a0.x, uy = static_cast<double>(a1.y) - a0.y;
+	const double vx = static_cast<double>(b1.x) - b0.x, vy = static_cast<double>(b1.y) - b0.y;
+	const double wx = static_cast<double>(b0.x) - a0.x, wy = static_cast<double>(b0.y) - a0.y;
+	const double t = (wx * vy - wy * vx) / (ux * vy - uy * vx);
+
+	const double minX = std::max(std::min(a0.x, a1.x), std::min(b0.x, b1.x)), maxX = std::min(std::max(a0.x, a1.x), std::max(b0.x, b1.x));
+	const double minY = std::max(std::min(a0.y, a1.y), std::min(b0.y, b1.y)), maxY = std::min(std::max(a0.y, a1.y), std::max(b0.y, b1.y));
+	return SweepPoint{ std::min(std::max(a0.x + t * ux, minX), maxX), std::min(std::max(a0.y + t * uy, minY), maxY) };
+}
+
+//Decides with exact predicates whether segments intersect, point is set to the crossing point or to the start of a collinear overlap
+static bool IntersectionPoint(SweepPoint& point, const Vector2& a0, const Vector2& a1, const Vector2& b0, const Vector2& b1)
+{
+	const int o1 = Sign(Predicates::Orient2D(a0, a1, b0));
+	const int o2 = Sign(Predicates::Orient2D(a0, a1, b1));
+	if (o1 * o2 > 0) return false;
+
+	const int o3 = Sign(Predicates::Orient2D(b0, b1, a0));
+	const int o4 = Sign(Predicates::Orient2D(b0, b1, a1));
+	if (o3 * o4 > 0) return false;
+
+	if (o1 == 0 && o2 == 0)
+	{
+		//Collinear, compare the ranges along the line
+		const SweepPoint aStart = std::min(ToPoint(a0), ToPoint(a1)), aEnd = std::max(ToPoint(a0), ToPoint(a1));
+		const SweepPoint bStart = std::min(ToPoint(b0), ToPoint(b1)), bEnd = std::max(ToPoint(b0), ToPoint(b1));
+		const SweepPoint start = std::max(aStart, bStart);
+		if (std::min(aEnd, bEnd) < start) return false;
+		point = start;
+		return true;
+	}
+
+	//Touching at an endpoint, the endpoint is the exact answer
+	if (o1 == 0) point = ToPoint(b0);
+	else if (o2 == 0) point = ToPoint(b1);
+	else if (o3 == 0) point = ToPoint(a0);
+	else if (o4 == 0) point = ToPoint(a1);
+	else point = CrossingPoint(a0, a1, b0, b1);
+
+	return true;
+}
+
+//Same as IntersectionPoint, but only segments crossing in the interior of both count
+static bool ProperCrossing(SweepPoint& point, const Vector2& a0, const Vector2& a1, const Vector2& b0, const Vector2& b1)
+{
+	if (Sign(Predicates::Orient2D(a0, a1, b0)) * Sign(Predicates::Orient2D(a0, a1, b1)) >= 0) return false;
+	if (Sign(Predicates::Orient2D(b0, b1, a0)) * Sign(Predicates::Orient2D(b0, b1, a1)) >= 0) return false;
+
+	point = CrossingPoint(a0, a1, b0, b1);
+	return true;
+}
+
+bool SegmentIntersection::Intersect(Vector2& intersection, const Vector2& a0, const Vector2& a1, const Vector2& b0, const Vector2& b1)
+{
+	SweepPoint point;
+	if (!IntersectionPoint(point, a0, a1, b0, b1)) return false;
+
+	intersection = Vector2(static_cast<float>(point.x), static_cast<float>(point.y));
+	return true;
+}
+
+void SegmentIntersection::BruteForce(const Vector2* points, const size_t segmentCount, const std::function<void(const Hit&)>& callback)
+{
+	std::vector<float> minX(segmentCount), minY(segmentCount), maxX(segmentCount), maxY(segmentCount);
+	for (size_t i = 0; i < segmentCount; i++)
+	{
+		minX[i] = std::min(points[i * 2].x, points[i * 2 + 1].x);
+		minY[i] = std::min(points[i * 2].y, points[i * 2 + 1].y);
+		maxX[i] = std::max(points[i * 2].x, points[i * 2 + 1].x);
+		maxY[i] = std::max(points[i * 2].y, points[i * 2 + 1].y);
+	}
+
+	const auto test = [&](const size_t i, const size_t j)
+	{
+		Vector2 intersection;
+		if (Intersect(intersection, points[i * 2], points[i * 2 + 1], points[j * 2], points[j * 2 + 1]))
+			callback(Hit{ static_cast<uint32_t>(i), static_cast<uint32_t>(j), intersection });
+	};
+
+	for (size_t i = 0; i < segmentCount; i++)
+	{
+		size_t j = i + 1;
+
+#ifdef SEGMENTINTERSECTION_SSE
+		const __m128 iMinX = _mm_set1_ps(minX[i]), iMinY = _mm_set1_ps(minY[i]);
+		const __m128 iMaxX = _mm_set1_ps(maxX[i]), iMaxY = _mm_set1_ps(maxY[i]);
+		for (; j + 4 <= segmentCount; j += 4)
+		{
+			__m128 overlap = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&minX[j]), iMaxX), _mm_cmple_ps(iMinX, _mm_loadu_ps(&maxX[j])));
+			overlap = _mm_and_ps(overlap, _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&minY[j]), iMaxY), _mm_cmple_ps(iMinY, _mm_loadu_ps(&maxY[j]))));
+
+			const int mask = _mm_movemask_ps(overlap);
+			for (int lane = 0; lane < 4; lane++)
+				if (mask & (1 << lane)) test(i, j + lane);
+		}
+#endif
+
+		for (; j < segmentCount; j++)
+		{
+			if (minX[j] <= maxX[i] && minX[i] <= maxX[j] && minY[j] <= maxY[i] && minY[i] <= maxY[j])
+				test(i, j);
+		}
+	}
+}
+
+//Segments oriented from their smaller to larger endpoint and the current endpoint event
+//Order of the status only changes through exact predicates, computed crossing points are used only to order the events
+struct SweepState
+{
+	std::vector<Vector2> start;
+	std::vector<Vector2> end;
+	Vector2 point;
+
+	//Returns positive value if the event point is above the segment and zero if it is on the segment
+	[[nodiscard]]
+	double Side(const uint32_t segment) const
+	{
+		return Predicates::Orient2D(start[segment], end[segment], point);
+	}
+
+	//Order of two segments through the event point right after it, collinear segments are ordered by index
+	[[nodiscard]]
+	bool Below(const uint32_t lhs, const uint32_t rhs) const
+	{
+		const double cross = Predicates::Cross(start[lhs], end[lhs], start[rhs], end[rhs]);
+		if (cross != 0) return cross > 0;
+		return lhs < rhs;
+	}
+};
+
+//Segment in the status, crossings swap the segments of two neighboring entries without touching the tree
+struct StatusEntry
+{
+	mutable uint32_t segment;
+};
+
+//Probe for the segments through the event point
+struct StatusProbe
+{
+};
+
+//Orders segments bottom to top. Entries are only compared while inserting at the event point, so one of them always passes through it
+struct StatusLess
+{
+	typedef void is_transparent;
+	const SweepState* state;
+
+	bool operator()(const StatusEntry& lhs, const StatusEntry& rhs) const
+	{
+		const double lhsSide = state->Side(lhs.segment);
+		const double rhsSide = state->Side(rhs.segment);
+		if (lhsSide == 0 && rhsSide == 0) return state->Below(lhs.segment, rhs.segment);
+		if (lhsSide == 0) return rhsSide < 0;
+		return lhsSide > 0;
+	}
+
+	bool operator()(const StatusEntry& lhs, const StatusProbe&) const
+	{
+		return state->Side(lhs.segment) > 0;
+	}
+
+	bool operator()(const StatusProbe&, const StatusEntry& rhs) const
+	{
+		return state->Side(rhs.segment) < 0;
+	}
+};
+
+//Pending swap of two neighbors, hit is the computed crossing and point is where it is handled
+struct Crossing
+{
+	SweepPoint point;
+	SweepPoint hit;
+	uint32_t lower;
+	uint32_t upper;
+
+	bool operator < (const Crossing& c) const
+	{
+		if (point < c.point || c.point < point) return point < c.point;
+		if (lower != c.lower) return lower < c.lower;
+		return upper < c.upper;
+	}
+};
+
+void SegmentIntersection::Sweep(const Vector2* points, const size_t segmentCount, const std::function<void(const Hit&)>& callback)
+{
+	SweepState state{ std::vector<Vector2>(segmentCount), std::vector<Vector2>(segmentCount), Vector2() };
+
+	//Endpoint events hold the segments starting at them, end points are events without segments
+	std::map<SweepPoint, std::vector<uint32_t>> endpoints;
+	for (uint32_t i = 0; i < segmentCount; i++)
+	{
+		state.start[i] = points[i * 2];
+		state.end[i] = points[i * 2 + 1];
+		if (ToPoint(state.end[i]) < ToPoint(state.start[i])) std::swap(state.start[i], state.end[i]);
+		endpoints[ToPoint(state.start[i])].push_back(i);
+		endpoints[ToPoint(state.end[i])];
+	}
+
+	typedef std::set<StatusEntry, StatusLess> Status;
+	Status status(StatusLess{ &state });
+	std::vector<Status::iterator> location(segmentCount, status.end());
+	std::set<Crossing> crossings;
+	SweepPoint position{ -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity() };
+
+	const auto report = [&](const uint32_t s, const uint32_t t, const SweepPoint& point)
+	{
+		callback(Hit{ std::min(s, t), std::max(s, t), Vector2(static_cast<float>(point.x), static_cast<float>(point.y)) });
+	};
+
+	//Neighbors are swapped at their crossing if the lower one is steeper, otherwise they already crossed or never will
+	//A crossing computed slightly behind the sweep is handled right away, the swap itself does not depend on the computed point
+	const auto queueCrossing = [&](const uint32_t lower, const uint32_t upper)
+	{
+		if (Predicates::Cross(state.start[lower], state.end[lower], state.start[upper], state.end[upper]) >= 0) return;
+
+		Crossing crossing{ {}, {}, lower, upper };
+		if (!ProperCrossing(crossing.hit, state.start[lower], state.end[lower], state.start[upper], state.end[upper])) return;
+		crossing.point = std::max(crossing.hit, position);
+		crossings.insert(crossing);
+	};
+
+	std::vector<uint32_t> group;
+	std::vector<uint32_t> continuing;
+	while (!endpoints.empty() || !crossings.empty())
+	{
+		if (!crossings.empty() && (endpoints.empty() || !(endpoints.begin()->first < crossings.begin()->point)))
+		{
+			const Crossing crossing = *crossings.begin();
+			crossings.erase(crossings.begin());
+			position = std::max(position, crossing.point);
+
+			//Stale if the pair is no longer next to each other, a swapped pair is never in the same order again
+			const auto lower = location[crossing.lower];
+			if (lower == status.end() || std::next(lower) == status.end() || std::next(lower)->segment != crossing.upper) continue;
+			const auto upper = std::next(lower);
+
+			report(crossing.lower, crossing.upper, crossing.hit);
+			std::swap(lower->segment, upper->segment);
+			location[crossing.lower] = upper;
+			location[crossing.upper] = lower;
+
+			if (lower != status.begin()) queueCrossing(std::prev(lower)->segment, lower->segment);
+			if (std::next(upper) != status.end()) queueCrossing(upper->segment, std::next(upper)->segment);
+			continue;
+		}
+
+		const SweepPoint point = endpoints.begin()->first;
+		std::vector<uint32_t> starts = std::move(endpoints.begin()->second);
+		endpoints.erase(endpoints.begin());
+		position = std::max(position, point);
+		state.point = Vector2(static_cast<float>(point.x), static_cast<float>(point.y));
+
+		//Segments through the point are next to each other in the status
+		const auto range = status.equal_range(StatusProbe{});
+		group.clear();
+		for (auto it = range.first; it != range.second; ++it)
+			group.push_back(it->segment);
+		const size_t existing = group.size();
+		group.insert(group.end(), starts.begin(), starts.end());
+
+		const auto isEndpoint = [&](const size_t i)
+		{
+			return i >= existing || ToPoint(state.start[group[i]]) == point || ToPoint(state.end[group[i]]) == point;
+		};
+
+		//Report pairs meeting at the point. Segments crossing in their interiors are reported here unless they were swapped already
+		for (size_t i = 0; i < group.size(); i++)
+		{
+			for (size_t j = i + 1; j < group.size(); j++)
+			{
+				const uint32_t s = group[i];
+				const uint32_t t = group[j];
+				if (isEndpoint(i) || isEndpoint(j))
+				{
+					SweepPoint hit;
+					if (IntersectionPoint(hit, state.start[s], state.end[s], state.start[t], state.end[t]) && hit == point) report(s, t, point);
+				}
+				else if (Predicates::Cross(state.start[s], state.end[s], state.start[t], state.end[t]) < 0) report(s, t, point);
+			}
+		}
+
+		//Remove everything through the point and reinsert segments that continue in their order after it
+		const auto above = status.erase(range.first, range.second);
+		continuing.clear();
+		for (const uint32_t segment : group)
+		{
+			location[segment] = status.end();
+			if (!(ToPoint(state.end[segment]) == point)) continuing.push_back(segment);
+		}
+
+		std::sort(continuing.begin(), continuing.end(), [&state](const uint32_t lhs, const uint32_t rhs) { return state.Below(lhs, rhs); });
+		for (const uint32_t segment : continuing)
+			location[segment] = status.insert(above, StatusEntry{ segment });
+
+		if (continuing.empty())
+		{
+			if (above != status.begin() && above != status.end())
+				queueCrossing(std::prev(above)->segment, above->segment);
+			continue;
+		}
+
+		const auto lowest = location[continuing.front()];
+		const auto highest = location[continuing.back()];
+		if (lowest != status.begin()) queueCrossing(std::prev(lowest)->segment, lowest->segment);
+		if (std::next(highest) != status.end()) queueCrossing(highest->segment, std::next(highest)->segment);
+	}
+}
+
+void SegmentIntersection::Find(const Vector2* points, const size_t segmentCount, std::vector<Hit>& hits)
+{
+	const auto append = [&hits](const Hit& hit) { hits.push_back(hit); };
+
+	if (segmentCount < bruteForceLimit) BruteForce(points, segmentCount, append);
+	else Sweep(points, segmentCount, append);
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "Vector.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+//Intersections among 2D line segments, every two consecutive points form a segment
+//Whether two segments intersect is decided with Predicates, so touching and collinear segments are reported exactly
+struct SegmentIntersection
+{
+	//Intersecting pair, first is always smaller than second. Overlapping collinear segments report the start of the overlap
+	struct Hit
+	{
+		uint32_t first;
+		uint32_t second;
+		Vector2 point;
+	};
+
+	//Inputs smaller than this run the brute force kernel in Find
+	static constexpr size_t bruteForceLimit = 64;
+
+	//Checks if segments a0-a1 and b0-b1 intersect, returns true if there is intersection. Output is saved to intersection
+	static bool Intersect(Vector2& intersection, const Vector2& a0, const Vector2& a1, const Vector2& b0, const Vector2& b1);
+
+	//Tests every pair of segments, bounding boxes are rejected four pairs at a time before the exact test
+	static void BruteForce(const Vector2* points, size_t segmentCount, const std::function<void(const Hit&)>& callback);
+
+	//Bentley-Ottmann sweep, reports every intersecting pair once in O((n + k) log n)
+	//Order of segments in the sweep only changes through exact predicates, so shared endpoints, collinear overlaps and many segments through one point are handled
+	//Hits are passed to callback as they are found, so memory does not grow with number of intersections
+	static void Sweep(const Vector2* points, size_t segmentCount, const std::function<void(const Hit&)>& callback);
+
+	//Picks brute force or sweep depending on input size and appends hits to buffer
+	static void Find(const Vector2* points, size_t segmentCount, std::vector<Hit>& hits);
+};
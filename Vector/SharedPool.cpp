@@ -0,0 +1,344 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: http://www.viva64.com
+
+#include "SharedPool.h"
+#include <algorithm>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//Start of every segment, everything that changes after creation is atomic since several processes access it at once
+struct SharedPool::Header
+{
+	static constexpr uint64_t expectedMagic = 0x4C4F4F5052544356;
+	static constexpr uint32_t expectedVersion = 1;
+	//Bank index stored in published before the first Publish
+	static constexpr uint32_t none = 2;
+
+	std::atomic<uint64_t> magic;
+	uint32_t version;
+	uint32_t headerSize;
+	uint64_t size;
+	uint64_t bankSize;
+	uint64_t bankStart[2];
+
+	std::atomic<uint32_t> published;
+	std::atomic<uint32_t> readers[2];
+	std::atomic<uint64_t> roots[2];
+	std::atomic<uint64_t> generations[2];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free, "Shared memory needs address free atomics");
+
+//Array alignment, also keeps arrays of different versions off each other's cache lines
+static constexpr uint64_t arrayAlignment = 64;
+
+static uint64_t AlignUp(const uint64_t value, const uint64_t alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+//POSIX names need a leading slash, Windows names must not have one
+static std::string SegmentName(const std::string& name)
+{
+#ifdef _WIN32
+	return !name.empty() && name[0] == '/' ? name.substr(1) : name;
+#else
+	return !name.empty() && name[0] == '/' ? name : "/" + name;
+#endif
+}
+
+SharedPool::Lease::~Lease()
+{
+	Release();
+}
+
+SharedPool::Lease::Lease(Lease&& other) noexcept : base(other.base), readers(other.readers), root(other.root), generation(other.generation)
+{
+	other.readers = nullptr;
+	other.base = nullptr;
+}
+
+SharedPool::Lease& SharedPool::Lease::operator=(Lease&& other) noexcept
+{
+	if (this == &other) return *this;
+
+	Release();
+	base = other.base;
+	readers = other.readers;
+	root = other.root;
+	generation = other.generation;
+	other.readers = nullptr;
+	other.base = nullptr;
+	return *this;
+}
+
+bool SharedPool::Lease::Valid() const
+{
+	return readers != nullptr;
+}
+
+uint64_t SharedPool::Lease::Generation() const
+{
+	return generation;
+}
+
+void SharedPool::Lease::Release()
+{
+	if (readers != nullptr) readers->fetch_sub(1, std::memory_order_release);
+	readers = nullptr;
+}
+
+SharedPool::~SharedPool()
+{
+	Close();
+}
+
+bool SharedPool::Create(const std::string& name, const size_t size)
+{
+	const size_t headerSize = AlignUp(sizeof(Header), arrayAlignment);
+	if (size < headerSize + 2 * arrayAlignment) return false;
+
+	Close();
+	Remove(name);
+	if (!Map(name, size, true)) return false;
+
+	Header& header = GetHeader();
+	header.version = Header::expectedVersion;
+	header.headerSize = static_cast<uint32_t>(headerSize);
+	header.size = size;
+	header.bankSize = (size - headerSize) / 2 / arrayAlignment * arrayAlignment;
+	header.bankStart[0] = headerSize;
+	header.bankStart[1] = headerSize + header.bankSize;
+	header.published.store(Header::none, std::memory_order_relaxed);
+	for (int bank = 0; bank < 2; bank++)
+	{
+		header.readers[bank].store(0, std::memory_order_relaxed);
+		header.roots[bank].store(0, std::memory_order_relaxed);
+		header.generations[bank].store(0, std::memory_order_relaxed);
+	}
+
+	//Written last, so a process opening the segment during creation sees it as not ready
+	header.magic.store(Header::expectedMagic, std::memory_order_release);
+
+	building = 0;
+	used = 0;
+	return true;
+}
+
+bool SharedPool::Open(const std::string& name)
+{
+	Close();
+	if (!Map(name, 0, false)) return false;
+
+	const Header& header = GetHeader();
+	if (header.magic.load(std::memory_order_acquire) != Header::expectedMagic || header.version != Header::expectedVersion || header.size > size)
+	{
+		Close();
+		return false;
+	}
+
+	//Nothing can be allocated until Begin
+	used = header.bankSize;
+	return true;
+}
+
+bool SharedPool::Map(const std::string& name, const size_t mapSize, const bool create)
+{
+	const std::string segment = SegmentName(name);
+
+#ifdef _WIN32
+	HANDLE handle;
+	if (create)
+	{
+		const uint64_t size64 = mapSize;
+		handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64), segment.c_str());
+	}
+	else
+	{
+		handle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, segment.c_str());
+	}
+	if (handle == nullptr) return false;
+
+	void* view = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, mapSize);
+	if (view == nullptr)
+	{
+		CloseHandle(handle);
+		return false;
+	}
+
+	size_t viewSize = mapSize;
+	if (!create)
+	{
+		MEMORY_BASIC_INFORMATION information;
+		viewSize = VirtualQuery(view, &information, sizeof(information)) != 0 ? information.RegionSize : 0;
+	}
+
+	mapping = handle;
+	base = static_cast<uint8_t*>(view);
+	size = viewSize;
+#else
+	const int descriptor = create ? shm_open(segment.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600) : shm_open(segment.c_str(), O_RDWR, 0);
+	if (descriptor < 0) return false;
+
+	size_t viewSize = mapSize;
+	struct stat status;
+	if (create ? ftruncate(descriptor, static_cast<off_t>(mapSize)) != 0 : fstat(descriptor, &status) != 0)
+	{
+		close(descriptor);
+		return false;
+	}
+	if (!create) viewSize = static_cast<size_t>(status.st_size);
+	if (viewSize < sizeof(Header))
+	{
+		close(descriptor);
+		return false;
+	}
+
+	void* view = mmap(nullptr, viewSize, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+	close(descriptor);
+	if (view == MAP_FAILED) return false;
+
+	base = static_cast<uint8_t*>(view);
+	size = viewSize;
+#endif
+
+	return true;
+}
+
+void SharedPool::Close()
+{
+	if (base == nullptr) return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(base);
+	CloseHandle(mapping);
+	mapping = nullptr;
+#else
+	munmap(base, size);
+#endif
+
+	base = nullptr;
+	size = 0;
+	used = 0;
+}
+
+bool SharedPool::Remove(const std::string& name)
+{
+#ifdef _WIN32
+	//Windows removes the mapping with its last handle
+	(void)name;
+	return true;
+#else
+	return shm_unlink(SegmentName(name).c_str()) == 0;
+#endif
+}
+
+SharedPool::Header& SharedPool::GetHeader() const
+{
+	return *reinterpret_cast<Header*>(base);
+}
+
+void SharedPool::Begin()
+{
+	Header& header = GetHeader();
+	const uint32_t published = header.published.load();
+	building = published == 0 ? 1 : 0;
+
+	//Readers that saw this bank as published before the last Publish may still use it
+	while (header.readers[building].load() != 0)
+		std::this_thread::yield();
+
+	used = 0;
+}
+
+uint64_t SharedPool::Allocate(const size_t bytes, const size_t alignment)
+{
+	const Header& header = GetHeader();
+	const uint64_t start = AlignUp(used, std::max<uint64_t>(alignment, arrayAlignment));
+	if (start > header.bankSize || bytes > header.bankSize - start) return 0;
+
+	used = start + bytes;
+	return header.bankStart[building] + start;
+}
+
+SharedVector3Soa SharedPool::StoreSoa(const Vector3* points, const size_t count)
+{
+	SharedVector3Soa soa;
+	soa.x = Allocate<float>(count);
+	soa.y = Allocate<float>(count);
+	soa.z = Allocate<float>(count);
+	if (!soa.x.Valid() || !soa.y.Valid() || !soa.z.Valid()) return SharedVector3Soa();
+
+	float* x = Data(soa.x);
+	float* y = Data(soa.y);
+	float* z = Data(soa.z);
+	for (size_t i = 0; i < count; i++)
+	{
+		x[i] = points[i].x;
+		y[i] = points[i].y;
+		z[i] = points[i].z;
+	}
+	return soa;
+}
+
+void SharedPool::Publish(const uint64_t root)
+{
+	Header& header = GetHeader();
+	const uint64_t generation = std::max(header.generations[0].load(), header.generations[1].load()) + 1;
+	header.roots[building].store(root, std::memory_order_relaxed);
+	header.generations[building].store(generation, std::memory_order_relaxed);
+	header.published.store(building);
+
+	//Bank stays readable until the next Begin, which moves to the other bank
+	used = header.bankSize;
+}
+
+SharedPool::Lease SharedPool::Acquire() const
+{
+	Lease lease;
+	Header& header = GetHeader();
+	for (;;)
+	{
+		const uint32_t bank = header.published.load();
+		if (bank == Header::none) return lease;
+
+		//Counted before the bank is checked again, so the writer either sees the count or this reader sees the new bank
+		header.readers[bank].fetch_add(1);
+		if (header.published.load() == bank)
+		{
+			lease.base = base;
+			lease.readers = &header.readers[bank];
+			lease.root = header.roots[bank].load(std::memory_order_relaxed);
+			lease.generation = header.generations[bank].load(std::memory_order_relaxed);
+			return lease;
+		}
+		header.readers[bank].fetch_sub(1);
+	}
+}
+
+uint64_t SharedPool::Generation() const
+{
+	const Header& header = GetHeader();
+	return std::max(header.generations[0].load(), header.generations[1].load());
+}
+
+size_t SharedPool::BankSize() const
+{
+	return static_cast<size_t>(GetHeader().bankSize);
+}
+
+bool SharedPool::IsOpen() const
+{
+	return base != nullptr;
+}
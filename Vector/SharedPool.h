@@ -0,0 +1,185 @@
+#pragma once
+#include "Vector.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+//Array stored in a SharedPool, addressed by its offset from the start of the segment so that the handle is valid in every process
+template <typename T>
+struct SharedArray
+{
+	uint64_t offset = 0;
+	uint64_t count = 0;
+
+	//Offset 0 is the pool header, so it never belongs to an array
+	[[nodiscard]]
+	bool Valid() const
+	{
+		return offset != 0;
+	}
+};
+
+//Vector3 array stored as three float arrays
+struct SharedVector3Soa
+{
+	SharedArray<float> x;
+	SharedArray<float> y;
+	SharedArray<float> z;
+};
+
+//Named shared memory segment that one process fills with vector arrays and many processes read without copying
+//Segment holds two banks: the writer builds a new version in the bank readers do not use, then publishes it with one atomic store
+//Readers take a Lease of the published bank, the writer waits until every lease of a bank is released before it overwrites that bank
+//Caution: Only one process may write to a pool, and a process that dies while holding a lease blocks the writer from reusing that bank !
+class SharedPool
+{
+public:
+	//Keeps the bank that was published when it was taken readable, its arrays stay valid until the lease is released
+	class Lease
+	{
+	public:
+		Lease() = default;
+		~Lease();
+
+		Lease(Lease&& other) noexcept;
+		Lease& operator=(Lease&& other) noexcept;
+
+		Lease(const Lease&) = delete;
+		Lease& operator=(const Lease&) = delete;
+
+		//Returns false if nothing was published when the lease was taken
+		[[nodiscard]]
+		bool Valid() const;
+
+		//Returns number of Publish calls up to and including this version
+		[[nodiscard]]
+		uint64_t Generation() const;
+
+		//Returns root object passed to Publish
+		template <typename Root>
+		[[nodiscard]]
+		const Root& GetRoot() const
+		{
+			return *reinterpret_cast<const Root*>(base + root);
+		}
+
+		template <typename T>
+		[[nodiscard]]
+		const T* Get(const SharedArray<T>& array) const
+		{
+			return reinterpret_cast<const T*>(base + array.offset);
+		}
+
+	private:
+		friend class SharedPool;
+		void Release();
+
+		const uint8_t* base = nullptr;
+		std::atomic<uint32_t>* readers = nullptr;
+		uint64_t root = 0;
+		uint64_t generation = 0;
+	};
+
+	SharedPool() = default;
+
+	//Unmaps the segment, the segment itself lives until Remove is called and every process has unmapped it
+	~SharedPool();
+
+	SharedPool(const SharedPool&) = delete;
+	SharedPool& operator=(const SharedPool&) = delete;
+
+	//Creates a segment of the given size in bytes, replacing an existing one with the same name, and becomes its writer
+	bool Create(const std::string& name, size_t size);
+
+	//Opens a segment created by another process for reading
+	bool Open(const std::string& name);
+
+	//Unmaps the segment
+	void Close();
+
+	//Removes the name of a segment, processes that have it mapped keep their mapping
+	static bool Remove(const std::string& name);
+
+	//Starts building a new version in the unpublished bank, blocks until every lease of that bank is released
+	//Caution: Arrays allocated before the previous Publish are overwritten !
+	void Begin();
+
+	//Allocates an uninitialized array in the bank being built, the handle is invalid when the bank is full
+	template <typename T>
+	SharedArray<T> Allocate(const size_t count)
+	{
+		//Vector types have user defined copy constructors, but standard layout is what makes them valid in another process
+		static_assert(std::is_standard_layout<T>::value, "Shared arrays must be standard layout");
+		SharedArray<T> array;
+		array.offset = count > SIZE_MAX / sizeof(T) ? 0 : Allocate(count * sizeof(T), alignof(T));
+		array.count = array.offset == 0 ? 0 : count;
+		return array;
+	}
+
+	//Allocates an array and copies data into it
+	template <typename T>
+	SharedArray<T> Store(const T* data, const size_t count)
+	{
+		const SharedArray<T> array = Allocate<T>(count);
+		if (array.Valid()) std::copy(data, data + count, Data(array));
+		return array;
+	}
+
+	//Stores points as three float arrays, handles are invalid when the bank is full
+	SharedVector3Soa StoreSoa(const Vector3* points, size_t count);
+
+	//Returns writable pointer to an array of the bank being built
+	template <typename T>
+	[[nodiscard]]
+	T* Data(const SharedArray<T>& array)
+	{
+		return reinterpret_cast<T*>(base + array.offset);
+	}
+
+	//Copies root into the bank being built and makes the bank the published version, returns false when it does not fit
+	//Root usually holds the handles of the arrays of the version
+	template <typename Root>
+	bool Publish(const Root& root)
+	{
+		static_assert(std::is_standard_layout<Root>::value, "Shared roots must be standard layout");
+		const SharedArray<Root> stored = Store(&root, 1);
+		if (!stored.Valid()) return false;
+		Publish(stored.offset);
+		return true;
+	}
+
+	//Takes a lease of the published version
+	[[nodiscard]]
+	Lease Acquire() const;
+
+	//Returns number of published versions
+	[[nodiscard]]
+	uint64_t Generation() const;
+
+	//Returns number of bytes one bank can hold
+	[[nodiscard]]
+	size_t BankSize() const;
+
+	[[nodiscard]]
+	bool IsOpen() const;
+
+private:
+	struct Header;
+
+	bool Map(const std::string& name, size_t size, bool create);
+	[[nodiscard]]
+	Header& GetHeader() const;
+	uint64_t Allocate(size_t bytes, size_t alignment);
+	void Publish(uint64_t root);
+
+	uint8_t* base = nullptr;
+	size_t size = 0;
+	uint32_t building = 0;
+	uint64_t used = 0;
+
+#ifdef _WIN32
+	void* mapping = nullptr;
+#endif
+};
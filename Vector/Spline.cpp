@@ -0,0 +1,47 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: http://www.viva64.com
+
+#include "Spline.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define SPLINE_SSE
+#endif
+
+void SplineKernels::Horner(const float* coefficients, const int dimensions, const float* parameters, const size_t count, float* output)
+{
+	size_t i = 0;
+
+#ifdef SPLINE_SSE
+	//Four parameters per iteration, each dimension is evaluated in its own register and then interleaved into the output
+	float lanes[4][4];
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 t = _mm_loadu_ps(parameters + i);
+		for (int dimension = 0; dimension < dimensions; dimension++)
+		{
+			const float* c = coefficients + dimension * 4;
+			__m128 result = _mm_set1_ps(c[3]);
+			result = _mm_add_ps(_mm_mul_ps(result, t), _mm_set1_ps(c[2]));
+			result = _mm_add_ps(_mm_mul_ps(result, t), _mm_set1_ps(c[1]));
+			result = _mm_add_ps(_mm_mul_ps(result, t), _mm_set1_ps(c[0]));
+			_mm_storeu_ps(lanes[dimension], result);
+		}
+
+		for (int lane = 0; lane < 4; lane++)
+			for (int dimension = 0; dimension < dimensions; dimension++)
+				output[(i + lane) * dimensions + dimension] = lanes[dimension][lane];
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		const float t = parameters[i];
+		for (int dimension = 0; dimension < dimensions; dimension++)
+		{
+			const float* c = coefficients + dimension * 4;
+			output[i * dimensions + dimension] = ((c[3] * t + c[2]) * t + c[1]) * t + c[0];
+		}
+	}
+}
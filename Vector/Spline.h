@@ -0,0 +1,260 @@
+#pragma once
+#include "Vector.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+//Horner kernel shared by every curve, evaluates four parameters at a time with SSE where available
+struct SplineKernels
+{
+	//Evaluates one cubic polynomial per dimension at count parameters
+	//Coefficients are stored per dimension from constant to cubic term, output is interleaved with dimensions floats per parameter
+	static void Horner(const float* coefficients, int dimensions, const float* parameters, size_t count, float* output);
+};
+
+//Single cubic piece in power basis, p(t) = ((c3 * t + c2) * t + c1) * t + c0 for t in [0, 1]
+//Evaluating the power basis replaces nested LerpNoClamp calls of de Casteljau's algorithm with three multiply adds per component
+template <typename T>
+struct Curve
+{
+	static_assert(std::is_standard_layout<T>::value && sizeof(T) % sizeof(float) == 0, "Curve needs a vector made of floats");
+	static constexpr int dimensions = static_cast<int>(sizeof(T) / sizeof(float));
+
+	T c0;
+	T c1;
+	T c2;
+	T c3;
+
+	static Curve QuadraticBezier(const T& p0, const T& p1, const T& p2)
+	{
+		return Curve{ p0, (p1 - p0) * 2, p0 - p1 * 2 + p2, T() };
+	}
+
+	static Curve Bezier(const T& p0, const T& p1, const T& p2, const T& p3)
+	{
+		return Curve{ p0, (p1 - p0) * 3, (p0 - p1 * 2 + p2) * 3, p3 - p0 + (p1 - p2) * 3 };
+	}
+
+	//Starts at p0 with tangent m0 and ends at p1 with tangent m1
+	static Curve Hermite(const T& p0, const T& m0, const T& p1, const T& m1)
+	{
+		return Curve{ p0, m0, (p1 - p0) * 3 - m0 * 2 - m1, (p0 - p1) * 2 + m0 + m1 };
+	}
+
+	//Uniform Catmull-Rom piece from p1 to p2
+	static Curve CatmullRom(const T& p0, const T& p1, const T& p2, const T& p3)
+	{
+		return Hermite(p1, (p2 - p0) * 0.5f, p2, (p3 - p1) * 0.5f);
+	}
+
+	[[nodiscard]]
+	T Evaluate(const float t) const
+	{
+		return ((c3 * t + c2) * t + c1) * t + c0;
+	}
+
+	[[nodiscard]]
+	T Derivative(const float t) const
+	{
+		return (c3 * (3 * t) + c2 * 2) * t + c1;
+	}
+
+	//Evaluates the curve at count parameters
+	void Evaluate(const float* parameters, const size_t count, T* output) const
+	{
+		float coefficients[dimensions * 4];
+		const T* terms[4] = { &c0, &c1, &c2, &c3 };
+		for (int dimension = 0; dimension < dimensions; dimension++)
+			for (int term = 0; term < 4; term++)
+				coefficients[dimension * 4 + term] = reinterpret_cast<const float*>(terms[term])[dimension];
+
+		SplineKernels::Horner(coefficients, dimensions, parameters, count, reinterpret_cast<float*>(output));
+	}
+};
+
+//Chain of cubic pieces, the whole spline is parameterized by u in [0, 1] and every piece covers an equal range of u
+template <typename T>
+class Spline
+{
+public:
+	//Batches at least this long are split across threads
+	static constexpr size_t parallelChunk = 16384;
+
+	//Pieces through every two points, needs 2 * pieces + 1 points
+	static Spline QuadraticBezier(const T* points, const size_t count)
+	{
+		Spline spline;
+		for (size_t i = 0; i + 2 < count; i += 2)
+			spline.pieces.push_back(Curve<T>::QuadraticBezier(points[i], points[i + 1], points[i + 2]));
+		return spline;
+	}
+
+	//Pieces through every three points, needs 3 * pieces + 1 points
+	static Spline Bezier(const T* points, const size_t count)
+	{
+		Spline spline;
+		for (size_t i = 0; i + 3 < count; i += 3)
+			spline.pieces.push_back(Curve<T>::Bezier(points[i], points[i + 1], points[i + 2], points[i + 3]));
+		return spline;
+	}
+
+	//Passes through every point with the given tangents
+	static Spline Hermite(const T* points, const T* tangents, const size_t count)
+	{
+		Spline spline;
+		for (size_t i = 0; i + 1 < count; i++)
+			spline.pieces.push_back(Curve<T>::Hermite(points[i], tangents[i], points[i + 1], tangents[i + 1]));
+		return spline;
+	}
+
+	//Passes through every point, first and last points are mirrored to get the end tangents
+	static Spline CatmullRom(const T* points, const size_t count)
+	{
+		Spline spline;
+		for (size_t i = 0; i + 1 < count; i++)
+		{
+			const T before = i > 0 ? points[i - 1] : points[0] * 2 - points[1];
+			const T after = i + 2 < count ? points[i + 2] : points[i + 1] * 2 - points[i];
+			spline.pieces.push_back(Curve<T>::CatmullRom(before, points[i], points[i + 1], after));
+		}
+		return spline;
+	}
+
+	[[nodiscard]]
+	const std::vector<Curve<T>>& Pieces() const
+	{
+		return pieces;
+	}
+
+	[[nodiscard]]
+	T Evaluate(const float u) const
+	{
+		if (pieces.empty()) return T();
+
+		const size_t piece = PieceIndex(u);
+		return pieces[piece].Evaluate(LocalParameter(u, piece));
+	}
+
+	//Returns derivative with respect to u
+	[[nodiscard]]
+	T Derivative(const float u) const
+	{
+		if (pieces.empty()) return T();
+
+		const size_t piece = PieceIndex(u);
+		return pieces[piece].Derivative(LocalParameter(u, piece)) * static_cast<float>(pieces.size());
+	}
+
+	//Evaluates the spline at count values of u. Consecutive values on the same piece are evaluated together, so sorted input is fastest
+	void Evaluate(const float* parameters, const size_t count, T* output) const
+	{
+		if (pieces.empty())
+		{
+			std::fill(output, output + count, T());
+			return;
+		}
+
+		Parallel::For(count, parallelChunk, [&](const size_t begin, const size_t end, unsigned)
+		{
+			float local[256];
+			size_t i = begin;
+			while (i < end)
+			{
+				const size_t piece = PieceIndex(parameters[i]);
+				size_t run = 0;
+				while (i + run < end && run < 256 && PieceIndex(parameters[i + run]) == piece)
+				{
+					local[run] = LocalParameter(parameters[i + run], piece);
+					run++;
+				}
+
+				pieces[piece].Evaluate(local, run, output + i);
+				i += run;
+			}
+		});
+	}
+
+	//Evaluates count points evenly spaced in u, including both ends
+	void Sample(const size_t count, T* output) const
+	{
+		std::vector<float> parameters(count);
+		for (size_t i = 0; i < count; i++)
+			parameters[i] = count > 1 ? static_cast<float>(i) / static_cast<float>(count - 1) : 0;
+
+		Evaluate(parameters.data(), count, output);
+	}
+
+	//Builds the table used for constant speed sampling by measuring samplesPerPiece chords on every piece
+	void BuildArcLengthTable(const size_t samplesPerPiece = 32)
+	{
+		const size_t sampleCount = pieces.size() * std::max<size_t>(samplesPerPiece, 1);
+		std::vector<T> points(sampleCount + 1);
+		Sample(sampleCount + 1, points.data());
+
+		arcLengths.assign(sampleCount + 1, 0);
+		Parallel::For(sampleCount, parallelChunk, [&](const size_t begin, const size_t end, unsigned)
+		{
+			for (size_t i = begin; i < end; i++)
+				arcLengths[i + 1] = T::Distance(points[i], points[i + 1]);
+		});
+
+		for (size_t i = 1; i <= sampleCount; i++)
+			arcLengths[i] += arcLengths[i - 1];
+	}
+
+	//Returns length of the spline
+	//Caution: Make sure BuildArcLengthTable is called after the last change !
+	[[nodiscard]]
+	float Length() const
+	{
+		return arcLengths.empty() ? 0 : arcLengths.back();
+	}
+
+	//Returns u at the given distance along the spline
+	//Caution: Make sure BuildArcLengthTable is called after the last change !
+	[[nodiscard]]
+	float ParameterAtDistance(const float distance) const
+	{
+		if (arcLengths.size() < 2 || distance <= 0) return 0;
+		if (distance >= arcLengths.back()) return 1;
+
+		const size_t upper = std::upper_bound(arcLengths.begin(), arcLengths.end(), distance) - arcLengths.begin();
+		const float chord = arcLengths[upper] - arcLengths[upper - 1];
+		const float fraction = chord > 0 ? (distance - arcLengths[upper - 1]) / chord : 0;
+		return (static_cast<float>(upper - 1) + fraction) / static_cast<float>(arcLengths.size() - 1);
+	}
+
+	//Evaluates count points evenly spaced along the spline, including both ends
+	//Caution: Make sure BuildArcLengthTable is called after the last change !
+	void SampleUniform(const size_t count, T* output) const
+	{
+		std::vector<float> parameters(count);
+		const float length = Length();
+		Parallel::For(count, parallelChunk, [&](const size_t begin, const size_t end, unsigned)
+		{
+			for (size_t i = begin; i < end; i++)
+				parameters[i] = ParameterAtDistance(count > 1 ? length * static_cast<float>(i) / static_cast<float>(count - 1) : 0);
+		});
+
+		Evaluate(parameters.data(), count, output);
+	}
+
+private:
+	[[nodiscard]]
+	size_t PieceIndex(const float u) const
+	{
+		const float scaled = std::min(std::max(u, 0.0f), 1.0f) * static_cast<float>(pieces.size());
+		return std::min(static_cast<size_t>(scaled), pieces.size() - 1);
+	}
+
+	[[nodiscard]]
+	float LocalParameter(const float u, const size_t piece) const
+	{
+		return std::min(std::max(u, 0.0f), 1.0f) * static_cast<float>(pieces.size()) - static_cast<float>(piece);
+	}
+
+	std::vector<Curve<T>> pieces;
+	std::vector<float> arcLengths;
+};
@@ -182,7 +182,7 @@ Vector3 Vector3::Reflect(const Vector3& vector, const Vector3& normal)
 }
 
 float Vector3::TriangleArea(const Vector3& a, const Vector3& b, const Vector3& c) {
-	return abs(Cross((a - c), (b - c)).Magnitude() / 2);
+	return std::fabs(Cross((a - c), (b - c)).Magnitude() / 2);
 }
 
 bool Vector3::PointTriangleIntersection(const Vector3& point, const Vector3& a, const Vector3& b, const Vector3& c) {
@@ -329,7 +329,7 @@ Vector2 Vector2::Perpendicular(const Vector2& vector)
 }
 
 float Vector2::TriangleArea(const Vector2& a, const Vector2& b, const Vector2& c) {
-	return static_cast<float>(abs((static_cast<double>(a.x) * (static_cast<double>(b.y) - c.y) + static_cast<double>(b.x) * 
+	return static_cast<float>(std::fabs((static_cast<double>(a.x) * (static_cast<double>(b.y) - c.y) + static_cast<double>(b.x) * 
 		(static_cast<double>(c.y) - a.y) + static_cast<double>(c.x) * (static_cast<double>(a.y) - b.y)) / 2.0));
 }
 
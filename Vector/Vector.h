@@ -382,6 +382,17 @@ struct Vector3 {
 		return *this;
 	}
 
+	/// Component access, 0 = x, 1 = y, 2 = z
+	float operator [] (const int index) const
+	{
+		return index == 0 ? x : index == 1 ? y : z;
+	}
+
+	float& operator [] (const int index)
+	{
+		return index == 0 ? x : index == 1 ? y : z;
+	}
+
 	//Logical operators
 	bool operator == (const Vector3& p) const;
 	bool operator !=(const Vector3& p) const;
@@ -0,0 +1,298 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: http://www.viva64.com
+
+#include "VectorBatch.h"
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#define VECTOR_BATCH_X64
+#endif
+
+//Kernels of one instruction set, filled by VectorBatchKernels.h
+struct KernelTable
+{
+	void (*angle2)(float* angles, const float* fromX, const float* fromY, const float* toX, const float* toY, size_t count);
+	void (*angle3)(float* angles, const float* fromX, const float* fromY, const float* fromZ, const float* toX, const float* toY, const float* toZ, size_t count);
+	void (*reflect2)(float* reflectedX, float* reflectedY, const float* x, const float* y, const float* normalX, const float* normalY, size_t count);
+	void (*reflect3)(float* reflectedX, float* reflectedY, float* reflectedZ, const float* x, const float* y, const float* z, const float* normalX, const float* normalY, const float* normalZ, size_t count);
+	void (*project3)(float* projectedX, float* projectedY, float* projectedZ, const float* x, const float* y, const float* z, const float* normalX, const float* normalY, const float* normalZ, size_t count);
+	void (*projectOnPlane3)(float* projectedX, float* projectedY, float* projectedZ, const float* x, const float* y, const float* z, const float* normalX, const float* normalY, const float* normalZ, size_t count);
+};
+
+//Plain float lane, used where no vector instruction set is available and as the reference the other paths are compared with
+namespace ScalarPath
+{
+	struct Lane
+	{
+		using Floats = float;
+		using Mask = bool;
+		static constexpr size_t width = 1;
+
+		static Floats Load(const float* source) { return *source; }
+		static void Store(float* destination, const Floats value) { *destination = value; }
+		static Floats Set(const float value) { return value; }
+		static Floats Add(const Floats lhs, const Floats rhs) { return lhs + rhs; }
+		static Floats Sub(const Floats lhs, const Floats rhs) { return lhs - rhs; }
+		static Floats Mul(const Floats lhs, const Floats rhs) { return lhs * rhs; }
+		static Floats Div(const Floats lhs, const Floats rhs) { return lhs / rhs; }
+		//a * b + c
+		static Floats MulAdd(const Floats a, const Floats b, const Floats c) { return a * b + c; }
+		//c - a * b
+		static Floats NegMulAdd(const Floats a, const Floats b, const Floats c) { return c - a * b; }
+		static Floats Min(const Floats lhs, const Floats rhs) { return std::min(lhs, rhs); }
+		static Floats Max(const Floats lhs, const Floats rhs) { return std::max(lhs, rhs); }
+		static Floats Abs(const Floats value) { return std::fabs(value); }
+		static Floats Sqrt(const Floats value) { return std::sqrt(value); }
+		static Floats ReciprocalEstimate(const Floats value) { return 1 / value; }
+		static Mask Less(const Floats lhs, const Floats rhs) { return lhs < rhs; }
+		static Mask Greater(const Floats lhs, const Floats rhs) { return lhs > rhs; }
+		static Floats Select(const Mask mask, const Floats whenTrue, const Floats whenFalse) { return mask ? whenTrue : whenFalse; }
+	};
+
+#include "VectorBatchKernels.h"
+}
+
+#ifdef VECTOR_BATCH_X64
+//SSE2 is part of x64, so this path needs no check
+namespace SsePath
+{
+	struct Lane
+	{
+		using Floats = __m128;
+		using Mask = __m128;
+		static constexpr size_t width = 4;
+
+		static Floats Load(const float* source) { return _mm_loadu_ps(source); }
+		static void Store(float* destination, const Floats value) { _mm_storeu_ps(destination, value); }
+		static Floats Set(const float value) { return _mm_set1_ps(value); }
+		static Floats Add(const Floats lhs, const Floats rhs) { return _mm_add_ps(lhs, rhs); }
+		static Floats Sub(const Floats lhs, const Floats rhs) { return _mm_sub_ps(lhs, rhs); }
+		static Floats Mul(const Floats lhs, const Floats rhs) { return _mm_mul_ps(lhs, rhs); }
+		static Floats Div(const Floats lhs, const Floats rhs) { return _mm_div_ps(lhs, rhs); }
+		static Floats MulAdd(const Floats a, const Floats b, const Floats c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+		static Floats NegMulAdd(const Floats a, const Floats b, const Floats c) { return _mm_sub_ps(c, _mm_mul_ps(a, b)); }
+		static Floats Min(const Floats lhs, const Floats rhs) { return _mm_min_ps(lhs, rhs); }
+		static Floats Max(const Floats lhs, const Floats rhs) { return _mm_max_ps(lhs, rhs); }
+		static Floats Abs(const Floats value) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), value); }
+		static Floats Sqrt(const Floats value) { return _mm_sqrt_ps(value); }
+		//12 bit estimate
+		static Floats ReciprocalEstimate(const Floats value) { return _mm_rcp_ps(value); }
+		static Mask Less(const Floats lhs, const Floats rhs) { return _mm_cmplt_ps(lhs, rhs); }
+		static Mask Greater(const Floats lhs, const Floats rhs) { return _mm_cmpgt_ps(lhs, rhs); }
+		static Floats Select(const Mask mask, const Floats whenTrue, const Floats whenFalse) { return _mm_or_ps(_mm_and_ps(mask, whenTrue), _mm_andnot_ps(mask, whenFalse)); }
+	};
+
+#include "VectorBatchKernels.h"
+}
+
+//Wider paths are compiled for their instruction set only, the rest of the file stays runnable on any x64 processor
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,fma"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+
+namespace Avx2Path
+{
+	struct Lane
+	{
+		using Floats = __m256;
+		using Mask = __m256;
+		static constexpr size_t width = 8;
+
+		static Floats Load(const float* source) { return _mm256_loadu_ps(source); }
+		static void Store(float* destination, const Floats value) { _mm256_storeu_ps(destination, value); }
+		static Floats Set(const float value) { return _mm256_set1_ps(value); }
+		static Floats Add(const Floats lhs, const Floats rhs) { return _mm256_add_ps(lhs, rhs); }
+		static Floats Sub(const Floats lhs, const Floats rhs) { return _mm256_sub_ps(lhs, rhs); }
+		static Floats Mul(const Floats lhs, const Floats rhs) { return _mm256_mul_ps(lhs, rhs); }
+		static Floats Div(const Floats lhs, const Floats rhs) { return _mm256_div_ps(lhs, rhs); }
+		static Floats MulAdd(const Floats a, const Floats b, const Floats c) { return _mm256_fmadd_ps(a, b, c); }
+		static Floats NegMulAdd(const Floats a, const Floats b, const Floats c) { return _mm256_fnmadd_ps(a, b, c); }
+		static Floats Min(const Floats lhs, const Floats rhs) { return _mm256_min_ps(lhs, rhs); }
+		static Floats Max(const Floats lhs, const Floats rhs) { return _mm256_max_ps(lhs, rhs); }
+		static Floats Abs(const Floats value) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), value); }
+		static Floats Sqrt(const Floats value) { return _mm256_sqrt_ps(value); }
+		//12 bit estimate
+		static Floats ReciprocalEstimate(const Floats value) { return _mm256_rcp_ps(value); }
+		static Mask Less(const Floats lhs, const Floats rhs) { return _mm256_cmp_ps(lhs, rhs, _CMP_LT_OQ); }
+		static Mask Greater(const Floats lhs, const Floats rhs) { return _mm256_cmp_ps(lhs, rhs, _CMP_GT_OQ); }
+		static Floats Select(const Mask mask, const Floats whenTrue, const Floats whenFalse) { return _mm256_blendv_ps(whenFalse, whenTrue, mask); }
+	};
+
+#include "VectorBatchKernels.h"
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#pragma clang attribute push(__attribute__((target("avx512f"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+//Intrinsics of some GCC versions start from a self initialized undefined register and trip this warning
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace Avx512Path
+{
+	struct Lane
+	{
+		using Floats = __m512;
+		using Mask = __mmask16;
+		static constexpr size_t width = 16;
+
+		static Floats Load(const float* source) { return _mm512_loadu_ps(source); }
+		static void Store(float* destination, const Floats value) { _mm512_storeu_ps(destination, value); }
+		static Floats Set(const float value) { return _mm512_set1_ps(value); }
+		static Floats Add(const Floats lhs, const Floats rhs) { return _mm512_add_ps(lhs, rhs); }
+		static Floats Sub(const Floats lhs, const Floats rhs) { return _mm512_sub_ps(lhs, rhs); }
+		static Floats Mul(const Floats lhs, const Floats rhs) { return _mm512_mul_ps(lhs, rhs); }
+		static Floats Div(const Floats lhs, const Floats rhs) { return _mm512_div_ps(lhs, rhs); }
+		static Floats MulAdd(const Floats a, const Floats b, const Floats c) { return _mm512_fmadd_ps(a, b, c); }
+		static Floats NegMulAdd(const Floats a, const Floats b, const Floats c) { return _mm512_fnmadd_ps(a, b, c); }
+		static Floats Min(const Floats lhs, const Floats rhs) { return _mm512_min_ps(lhs, rhs); }
+		static Floats Max(const Floats lhs, const Floats rhs) { return _mm512_max_ps(lhs, rhs); }
+		static Floats Abs(const Floats value) { return _mm512_abs_ps(value); }
+		static Floats Sqrt(const Floats value) { return _mm512_sqrt_ps(value); }
+		//14 bit estimate
+		static Floats ReciprocalEstimate(const Floats value) { return _mm512_rcp14_ps(value); }
+		static Mask Less(const Floats lhs, const Floats rhs) { return _mm512_cmp_ps_mask(lhs, rhs, _CMP_LT_OQ); }
+		static Mask Greater(const Floats lhs, const Floats rhs) { return _mm512_cmp_ps_mask(lhs, rhs, _CMP_GT_OQ); }
+		static Floats Select(const Mask mask, const Floats whenTrue, const Floats whenFalse) { return _mm512_mask_blend_ps(mask, whenFalse, whenTrue); }
+	};
+
+#include "VectorBatchKernels.h"
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+#endif
+#endif
+
+namespace
+{
+	//Forced path, or -1 to use the supported one
+	std::atomic<int> forcedPath{ -1 };
+
+	VectorBatch::Path DetectPath()
+	{
+#ifdef VECTOR_BATCH_X64
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 1);
+		const bool osSavesAvx = (info[2] & 1 << 27) != 0;
+		const bool fma = (info[2] & 1 << 12) != 0;
+		if (!osSavesAvx) return VectorBatch::Path::SSE;
+
+		//Operating system has to save the vector registers, ymm for AVX2 and additionally zmm and mask registers for AVX-512
+		const unsigned long long enabled = _xgetbv(0);
+		__cpuidex(info, 7, 0);
+		if ((enabled & 0xE6) == 0xE6 && (info[1] & 1 << 16) != 0) return VectorBatch::Path::AVX512;
+		if ((enabled & 0x6) == 0x6 && (info[1] & 1 << 5) != 0 && fma) return VectorBatch::Path::AVX2;
+		return VectorBatch::Path::SSE;
+#else
+		//Checks the state the operating system saves too
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f")) return VectorBatch::Path::AVX512;
+		if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return VectorBatch::Path::AVX2;
+		return VectorBatch::Path::SSE;
+#endif
+#else
+		return VectorBatch::Path::Scalar;
+#endif
+	}
+
+	const KernelTable& Kernels()
+	{
+		switch (VectorBatch::ActivePath())
+		{
+#ifdef VECTOR_BATCH_X64
+		case VectorBatch::Path::AVX512:
+			return Avx512Path::kernels;
+		case VectorBatch::Path::AVX2:
+			return Avx2Path::kernels;
+		case VectorBatch::Path::SSE:
+			return SsePath::kernels;
+#endif
+		default:
+			return ScalarPath::kernels;
+		}
+	}
+}
+
+VectorBatch::Path VectorBatch::SupportedPath()
+{
+	static const Path path = DetectPath();
+	return path;
+}
+
+VectorBatch::Path VectorBatch::ActivePath()
+{
+	const int forced = forcedPath.load(std::memory_order_relaxed);
+	return forced < 0 ? SupportedPath() : static_cast<Path>(forced);
+}
+
+void VectorBatch::SetPath(const Path path)
+{
+	forcedPath.store(static_cast<int>(std::min(path, SupportedPath())), std::memory_order_relaxed);
+}
+
+const char* VectorBatch::PathName(const Path path)
+{
+	switch (path)
+	{
+	case Path::SSE:
+		return "SSE";
+	case Path::AVX2:
+		return "AVX2";
+	case Path::AVX512:
+		return "AVX512";
+	default:
+		return "scalar";
+	}
+}
+
+void VectorBatch::Angle(float* angles, const Vector2Soa<const float>& from, const Vector2Soa<const float>& to, const size_t count)
+{
+	Kernels().angle2(angles, from.x, from.y, to.x, to.y, count);
+}
+
+void VectorBatch::Angle(float* angles, const Vector3Soa<const float>& from, const Vector3Soa<const float>& to, const size_t count)
+{
+	Kernels().angle3(angles, from.x, from.y, from.z, to.x, to.y, to.z, count);
+}
+
+void VectorBatch::Reflect(const Vector2Soa<float>& reflected, const Vector2Soa<const float>& vectors, const Vector2Soa<const float>& normals, const size_t count)
+{
+	Kernels().reflect2(reflected.x, reflected.y, vectors.x, vectors.y, normals.x, normals.y, count);
+}
+
+void VectorBatch::Reflect(const Vector3Soa<float>& reflected, const Vector3Soa<const float>& vectors, const Vector3Soa<const float>& normals, const size_t count)
+{
+	Kernels().reflect3(reflected.x, reflected.y, reflected.z, vectors.x, vectors.y, vectors.z, normals.x, normals.y, normals.z, count);
+}
+
+void VectorBatch::Project(const Vector3Soa<float>& projected, const Vector3Soa<const float>& vectors, const Vector3Soa<const float>& normals, const size_t count)
+{
+	Kernels().project3(projected.x, projected.y, projected.z, vectors.x, vectors.y, vectors.z, normals.x, normals.y, normals.z, count);
+}
+
+void VectorBatch::ProjectOnPlane(const Vector3Soa<float>& projected, const Vector3Soa<const float>& vectors, const Vector3Soa<const float>& planeNormals, const size_t count)
+{
+	Kernels().projectOnPlane3(projected.x, projected.y, projected.z, vectors.x, vectors.y, vectors.z, planeNormals.x, planeNormals.y, planeNormals.z, count);
+}
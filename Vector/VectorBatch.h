@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+
+//Vector arrays stored as one float array per component, Float is const float for inputs
+//Constructors take exactly one array per component, so a braced list of two arrays only converts to Vector2Soa and overloads of both stay unambiguous
+template <typename Float>
+struct Vector2Soa
+{
+	Vector2Soa(Float* x, Float* y) : x(x), y(y) { ; }
+
+	Float* x;
+	Float* y;
+};
+
+template <typename Float>
+struct Vector3Soa
+{
+	Vector3Soa(Float* x, Float* y, Float* z) : x(x), y(y), z(z) { ; }
+
+	Float* x;
+	Float* y;
+	Float* z;
+};
+
+//Batch versions of Angle, Reflect, Project and ProjectOnPlane of Vector2 and Vector3 over SoA arrays, element i of every array forms one call
+//Batches run on the widest instruction set the processor supports, checked once at run time: AVX-512, AVX2 with FMA, SSE2 or plain scalar code
+//Every path evaluates the same formulas, results of different paths only differ by the rounding of fused multiply adds and reciprocal estimates
+//Divisions of Project and ProjectOnPlane are replaced by a reciprocal estimate refined with one Newton step, which costs at most one more ULP, Angle divides exactly
+//Caution: Squared lengths and dot products are computed in float, inputs whose squares overflow or underflow give wrong results, like the scalar versions !
+struct VectorBatch
+{
+	//Ordered from narrowest to widest
+	enum class Path
+	{
+		Scalar,
+		SSE,
+		AVX2,
+		AVX512
+	};
+
+	//Widest path the processor and the operating system support
+	[[nodiscard]]
+	static Path SupportedPath();
+
+	//Path the batches run on, SupportedPath() unless another one was set
+	[[nodiscard]]
+	static Path ActivePath();
+
+	//Forces a path, e.g. to compare paths with each other, a path wider than SupportedPath() falls back to SupportedPath()
+	//Caution: Path is global, do not change it while other threads run batches !
+	static void SetPath(Path path);
+
+	[[nodiscard]]
+	static const char* PathName(Path path);
+
+	//Angle in degrees between from and to, the same as Vector2::Angle and Vector3::Angle
+	//Evaluated as atan2 of the cross and dot products with a polynomial arctangent, so unlike acos of the normalized dot product it needs no normalization and keeps its accuracy near 0 and 180 degrees
+	//Absolute error stays below 2e-5 degrees, the rounding of the cross and dot products of nearly parallel vectors, while acos of a rounded cosine is off by up to 4e-2 degrees there. Zero vectors give NaN
+	static void Angle(float* angles, const Vector2Soa<const float>& from, const Vector2Soa<const float>& to, size_t count);
+
+	static void Angle(float* angles, const Vector3Soa<const float>& from, const Vector3Soa<const float>& to, size_t count);
+
+	//Reflects vectors using normal vectors, the same as Vector2::Reflect and Vector3::Reflect, no approximation is involved
+	//Caution: Make sure normal vectors are normalized !
+	static void Reflect(const Vector2Soa<float>& reflected, const Vector2Soa<const float>& vectors, const Vector2Soa<const float>& normals, size_t count);
+
+	static void Reflect(const Vector3Soa<float>& reflected, const Vector3Soa<const float>& vectors, const Vector3Soa<const float>& normals, size_t count);
+
+	//Projects vectors on normal vectors, the same as Vector3::Project, normals shorter than sqrt(FLT_EPSILON) give zero
+	//Error of every component stays below 3 * FLT_EPSILON times the length of the vector
+	static void Project(const Vector3Soa<float>& projected, const Vector3Soa<const float>& vectors, const Vector3Soa<const float>& normals, size_t count);
+
+	//Projects vectors on planes through the origin, the same as Vector3::ProjectOnPlane, normals shorter than sqrt(FLT_EPSILON) leave vectors unchanged
+	//Error of every component stays below 3 * FLT_EPSILON times the length of the vector
+	static void ProjectOnPlane(const Vector3Soa<float>& projected, const Vector3Soa<const float>& vectors, const Vector3Soa<const float>& planeNormals, size_t count);
+};
@@ -0,0 +1,148 @@
+//Kernels of VectorBatch written once against Lane, the vector type of one instruction set
+//VectorBatch.cpp includes this file once per instruction set, inside a namespace that defines Lane and with code generation set for that instruction set
+//Caution: No include guard on purpose, do not include this file anywhere else !
+
+using Floats = Lane::Floats;
+using Mask = Lane::Mask;
+
+//Calls block on Lane::width elements at a time, the tail is copied into buffers padded with ones so that it runs the same code
+template <int inputs, int outputs, typename Block>
+static void Run(float* const (&out)[outputs], const float* const (&in)[inputs], const size_t count, Block block)
+{
+	size_t i = 0;
+	for (; i + Lane::width <= count; i += Lane::width)
+	{
+		Floats values[inputs];
+		Floats results[outputs];
+		for (int k = 0; k < inputs; k++) values[k] = Lane::Load(in[k] + i);
+		block(results, values);
+		for (int k = 0; k < outputs; k++) Lane::Store(out[k] + i, results[k]);
+	}
+	if (i == count) return;
+
+	const size_t tail = count - i;
+	float buffer[inputs > outputs ? inputs : outputs][Lane::width];
+	Floats values[inputs];
+	Floats results[outputs];
+	for (int k = 0; k < inputs; k++)
+	{
+		for (size_t j = 0; j < Lane::width; j++) buffer[k][j] = j < tail ? in[k][i + j] : 1.0f;
+		values[k] = Lane::Load(buffer[k]);
+	}
+	block(results, values);
+	for (int k = 0; k < outputs; k++)
+	{
+		Lane::Store(buffer[k], results[k]);
+		for (size_t j = 0; j < tail; j++) out[k][i + j] = buffer[k][j];
+	}
+}
+
+//1 / x from the estimate of the instruction set refined with one Newton step
+static Floats Reciprocal(const Floats x)
+{
+	const Floats estimate = Lane::ReciprocalEstimate(x);
+	return Lane::MulAdd(estimate, Lane::NegMulAdd(x, estimate, Lane::Set(1)), estimate);
+}
+
+//atan2(y, x) in degrees for y >= 0
+//Octant is folded so that the ratio is in [0, 1], ratios above tan(22.5) are rotated by 45 degrees into [-tan(22.5), 0], which keeps the single division
+//Arctangent of the ratio r is r * P(r^2) with P a degree 5 minimax polynomial, relative error 6e-10 before rounding
+//Both zero gives 0 / 0 and so NaN, the same as the angle of a zero vector
+//The ratio is a true division, reciprocal estimates give zero above 2^126 and infinity for denormals and the operands span the whole float range
+static Floats AngleDegrees(const Floats y, const Floats x)
+{
+	const Floats absoluteX = Lane::Abs(x);
+	const Floats low = Lane::Min(absoluteX, y);
+	const Floats high = Lane::Max(absoluteX, y);
+	const Mask rotate = Lane::Greater(low, Lane::Mul(high, Lane::Set(0.41421356f)));
+
+	const Floats numerator = Lane::Select(rotate, Lane::Sub(low, high), low);
+	const Floats denominator = Lane::Select(rotate, Lane::Add(low, high), high);
+	const Floats ratio = Lane::Div(numerator, denominator);
+
+	const Floats square = Lane::Mul(ratio, ratio);
+	Floats polynomial = Lane::Set(-0.0603479041f);
+	polynomial = Lane::MulAdd(polynomial, square, Lane::Set(0.105734798f));
+	polynomial = Lane::MulAdd(polynomial, square, Lane::Set(-0.142400830f));
+	polynomial = Lane::MulAdd(polynomial, square, Lane::Set(0.199982169f));
+	polynomial = Lane::MulAdd(polynomial, square, Lane::Set(-0.333333076f));
+	const Floats arctangent = Lane::MulAdd(Lane::Mul(ratio, square), polynomial, ratio);
+
+	Floats angle = Lane::MulAdd(arctangent, Lane::Set(57.2957795f), Lane::Select(rotate, Lane::Set(45), Lane::Set(0)));
+	angle = Lane::Select(Lane::Greater(y, absoluteX), Lane::Sub(Lane::Set(90), angle), angle);
+	return Lane::Select(Lane::Less(x, Lane::Set(0)), Lane::Sub(Lane::Set(180), angle), angle);
+}
+
+static void Angle2(float* angles, const float* fromX, const float* fromY, const float* toX, const float* toY, const size_t count)
+{
+	Run<4, 1>({ angles }, { fromX, fromY, toX, toY }, count, [](Floats* results, const Floats* values)
+	{
+		const Floats cross = Lane::NegMulAdd(values[1], values[2], Lane::Mul(values[0], values[3]));
+		const Floats dot = Lane::MulAdd(values[1], values[3], Lane::Mul(values[0], values[2]));
+		results[0] = AngleDegrees(Lane::Abs(cross), dot);
+	});
+}
+
+static void Angle3(float* angles, const float* fromX, const float* fromY, const float* fromZ, const float* toX, const float* toY, const float* toZ, const size_t count)
+{
+	Run<6, 1>({ angles }, { fromX, fromY, fromZ, toX, toY, toZ }, count, [](Floats* results, const Floats* values)
+	{
+		const Floats crossX = Lane::NegMulAdd(values[2], values[4], Lane::Mul(values[1], values[5]));
+		const Floats crossY = Lane::NegMulAdd(values[0], values[5], Lane::Mul(values[2], values[3]));
+		const Floats crossZ = Lane::NegMulAdd(values[1], values[3], Lane::Mul(values[0], values[4]));
+		const Floats crossLength = Lane::Sqrt(Lane::MulAdd(crossZ, crossZ, Lane::MulAdd(crossY, crossY, Lane::Mul(crossX, crossX))));
+		const Floats dot = Lane::MulAdd(values[2], values[5], Lane::MulAdd(values[1], values[4], Lane::Mul(values[0], values[3])));
+		results[0] = AngleDegrees(crossLength, dot);
+	});
+}
+
+static void Reflect2(float* reflectedX, float* reflectedY, const float* x, const float* y, const float* normalX, const float* normalY, const size_t count)
+{
+	Run<4, 2>({ reflectedX, reflectedY }, { x, y, normalX, normalY }, count, [](Floats* results, const Floats* values)
+	{
+		const Floats dot = Lane::MulAdd(values[1], values[3], Lane::Mul(values[0], values[2]));
+		const Floats scale = Lane::Mul(dot, Lane::Set(-2));
+		results[0] = Lane::MulAdd(scale, values[2], values[0]);
+		results[1] = Lane::MulAdd(scale, values[3], values[1]);
+	});
+}
+
+static void Reflect3(float* reflectedX, float* reflectedY, float* reflectedZ, const float* x, const float* y, const float* z, const float* normalX, const float* normalY, const float* normalZ, const size_t count)
+{
+	Run<6, 3>({ reflectedX, reflectedY, reflectedZ }, { x, y, z, normalX, normalY, normalZ }, count, [](Floats* results, const Floats* values)
+	{
+		const Floats dot = Lane::MulAdd(values[2], values[5], Lane::MulAdd(values[1], values[4], Lane::Mul(values[0], values[3])));
+		const Floats scale = Lane::Mul(dot, Lane::Set(-2));
+		for (int axis = 0; axis < 3; axis++) results[axis] = Lane::MulAdd(scale, values[3 + axis], values[axis]);
+	});
+}
+
+//Scale of the normal that projects the vector on it, zero where the normal is too short
+//Reciprocal estimates give zero above 2^126, so the squared magnitude is scaled by 2^-16 first and the scale by 2^-16 after, which is exact
+static Floats ProjectionScale(const Floats* values)
+{
+	const Floats dot = Lane::MulAdd(values[2], values[5], Lane::MulAdd(values[1], values[4], Lane::Mul(values[0], values[3])));
+	const Floats sqrMagnitude = Lane::MulAdd(values[5], values[5], Lane::MulAdd(values[4], values[4], Lane::Mul(values[3], values[3])));
+	const Floats scale = Lane::Mul(Lane::Mul(dot, Reciprocal(Lane::Mul(sqrMagnitude, Lane::Set(1.0f / 65536)))), Lane::Set(1.0f / 65536));
+	return Lane::Select(Lane::Less(sqrMagnitude, Lane::Set(FLT_EPSILON)), Lane::Set(0), scale);
+}
+
+static void Project3(float* projectedX, float* projectedY, float* projectedZ, const float* x, const float* y, const float* z, const float* normalX, const float* normalY, const float* normalZ, const size_t count)
+{
+	Run<6, 3>({ projectedX, projectedY, projectedZ }, { x, y, z, normalX, normalY, normalZ }, count, [](Floats* results, const Floats* values)
+	{
+		const Floats scale = ProjectionScale(values);
+		for (int axis = 0; axis < 3; axis++) results[axis] = Lane::Mul(values[3 + axis], scale);
+	});
+}
+
+static void ProjectOnPlane3(float* projectedX, float* projectedY, float* projectedZ, const float* x, const float* y, const float* z, const float* normalX, const float* normalY, const float* normalZ, const size_t count)
+{
+	Run<6, 3>({ projectedX, projectedY, projectedZ }, { x, y, z, normalX, normalY, normalZ }, count, [](Floats* results, const Floats* values)
+	{
+		const Floats scale = ProjectionScale(values);
+		for (int axis = 0; axis < 3; axis++) results[axis] = Lane::NegMulAdd(values[3 + axis], scale, values[axis]);
+	});
+}
+
+static const KernelTable kernels = { Angle2, Angle3, Reflect2, Reflect3, Project3, ProjectOnPlane3 };
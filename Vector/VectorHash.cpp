@@ -0,0 +1,165 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: http://www.viva64.com
+
+#include "VectorHash.h"
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	//Cells from floor are used up to 2^62, so neighbour cells never overflow
+	constexpr int64_t cellLimit = static_cast<int64_t>(1) << 62;
+
+	uint64_t Mix(uint64_t hash)
+	{
+		hash ^= hash >> 33;
+		hash *= 0xFF51AFD7ED558CCDull;
+		hash ^= hash >> 33;
+		hash *= 0xC4CEB9FE1A85EC53ull;
+		hash ^= hash >> 33;
+		return hash;
+	}
+
+	//Bits of value with negative zero turned into zero, so values that compare equal hash equal
+	uint32_t Bits(float value)
+	{
+		if (value == 0) value = 0;
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	template <typename Vector>
+	size_t ExactHash(const Vector& vector)
+	{
+		uint64_t hash = 0;
+		for (int axis = 0; axis < VectorTraits<Vector>::dimensions; axis++)
+			hash = Mix(hash ^ (Bits(VectorTraits<Vector>::Get(vector, axis)) + 0x9E3779B97F4A7C15ull * (axis + 1)));
+		return static_cast<size_t>(hash);
+	}
+
+	template <typename Vector>
+	bool ExactEqual(const Vector& lhs, const Vector& rhs)
+	{
+		for (int axis = 0; axis < VectorTraits<Vector>::dimensions; axis++)
+			if (VectorTraits<Vector>::Get(lhs, axis) != VectorTraits<Vector>::Get(rhs, axis)) return false;
+		return true;
+	}
+
+	template <typename Vector>
+	void Cells(int64_t* cells, const Vector& vector, const float cellSize)
+	{
+		const double inverseCellSize = cellSize > 0 ? 1.0 / cellSize : 1;
+		for (int axis = 0; axis < VectorTraits<Vector>::dimensions; axis++)
+			cells[axis] = VectorCells::Cell(VectorTraits<Vector>::Get(vector, axis), inverseCellSize);
+	}
+
+	template <typename Vector>
+	size_t QuantizedHash(const Vector& vector, const float cellSize)
+	{
+		int64_t cells[VectorTraits<Vector>::dimensions];
+		Cells(cells, vector, cellSize);
+		return static_cast<size_t>(VectorCells::Hash(cells, VectorTraits<Vector>::dimensions));
+	}
+
+	template <typename Vector>
+	bool QuantizedEqual(const Vector& lhs, const Vector& rhs, const float cellSize)
+	{
+		int64_t lhsCells[VectorTraits<Vector>::dimensions];
+		int64_t rhsCells[VectorTraits<Vector>::dimensions];
+		Cells(lhsCells, lhs, cellSize);
+		Cells(rhsCells, rhs, cellSize);
+		return std::memcmp(lhsCells, rhsCells, sizeof(lhsCells)) == 0;
+	}
+}
+
+int64_t VectorCells::Cell(const float value, const double inverseCellSize)
+{
+	double fraction;
+	return Cell(fraction, value, inverseCellSize);
+}
+
+int64_t VectorCells::Cell(double& fraction, const float value, const double inverseCellSize)
+{
+	const double position = value * inverseCellSize;
+	const double cell = std::floor(position);
+	fraction = 0;
+	if (std::isnan(cell)) return -cellLimit;
+	if (std::fabs(cell) >= static_cast<double>(cellLimit))
+	{
+		//Floats this far out are more than 2^39 cells apart, so each one gets a cell of its own after the floor cells, numbered by its bits
+		const int64_t outer = cellLimit + Bits(std::fabs(value));
+		return value < 0 ? -outer : outer;
+	}
+	fraction = position - cell;
+	return static_cast<int64_t>(cell);
+}
+
+uint64_t VectorCells::Hash(const int64_t* cells, const int dimensions)
+{
+	uint64_t hash = 0;
+	for (int axis = 0; axis < dimensions; axis++)
+		hash = Mix(hash ^ (static_cast<uint64_t>(cells[axis]) + 0x9E3779B97F4A7C15ull * (axis + 1)));
+	return hash;
+}
+
+size_t VectorHash::operator()(const Vector2& vector) const
+{
+	return ExactHash(vector);
+}
+
+size_t VectorHash::operator()(const Vector3& vector) const
+{
+	return ExactHash(vector);
+}
+
+size_t VectorHash::operator()(const Vector4& vector) const
+{
+	return ExactHash(vector);
+}
+
+bool VectorEqual::operator()(const Vector2& lhs, const Vector2& rhs) const
+{
+	return ExactEqual(lhs, rhs);
+}
+
+bool VectorEqual::operator()(const Vector3& lhs, const Vector3& rhs) const
+{
+	return ExactEqual(lhs, rhs);
+}
+
+bool VectorEqual::operator()(const Vector4& lhs, const Vector4& rhs) const
+{
+	return ExactEqual(lhs, rhs);
+}
+
+size_t QuantizedVectorHash::operator()(const Vector2& vector) const
+{
+	return QuantizedHash(vector, cellSize);
+}
+
+size_t QuantizedVectorHash::operator()(const Vector3& vector) const
+{
+	return QuantizedHash(vector, cellSize);
+}
+
+size_t QuantizedVectorHash::operator()(const Vector4& vector) const
+{
+	return QuantizedHash(vector, cellSize);
+}
+
+bool QuantizedVectorEqual::operator()(const Vector2& lhs, const Vector2& rhs) const
+{
+	return QuantizedEqual(lhs, rhs, cellSize);
+}
+
+bool QuantizedVectorEqual::operator()(const Vector3& lhs, const Vector3& rhs) const
+{
+	return QuantizedEqual(lhs, rhs, cellSize);
+}
+
+bool QuantizedVectorEqual::operator()(const Vector4& lhs, const Vector4& rhs) const
+{
+	return QuantizedEqual(lhs, rhs, cellSize);
+}
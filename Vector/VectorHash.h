@@ -0,0 +1,352 @@
+#pragma once
+#include "Vector.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define VECTOR_HASH_SSE
+#endif
+
+//Hashing policies for Vector2, Vector3 and Vector4 keys, every hash comes with the equality it is consistent with
+//Caution: operator== of the vectors is tolerance based and does not agree with any hash, pass one of the equality functors below to hash containers !
+
+//Hashes component bits, equal when every component is equal. Negative zero is equal to zero and hashes like it
+//Caution: NaN components are never equal, keys containing them cannot be found again !
+struct VectorHash
+{
+	size_t operator()(const Vector2& vector) const;
+	size_t operator()(const Vector3& vector) const;
+	size_t operator()(const Vector4& vector) const;
+};
+
+struct VectorEqual
+{
+	bool operator()(const Vector2& lhs, const Vector2& rhs) const;
+	bool operator()(const Vector3& lhs, const Vector3& rhs) const;
+	bool operator()(const Vector4& lhs, const Vector4& rhs) const;
+};
+
+//Hashes the grid cell of size cellSize a vector falls in, equal when both vectors are in the same cell
+//Unlike a tolerance this is transitive, but two vectors closer than cellSize can still be in neighbouring cells, VectorMap handles that case
+struct QuantizedVectorHash
+{
+	explicit QuantizedVectorHash(float cellSize = 1e-4f) : cellSize(cellSize) { ; }
+
+	size_t operator()(const Vector2& vector) const;
+	size_t operator()(const Vector3& vector) const;
+	size_t operator()(const Vector4& vector) const;
+
+	float cellSize;
+};
+
+struct QuantizedVectorEqual
+{
+	explicit QuantizedVectorEqual(float cellSize = 1e-4f) : cellSize(cellSize) { ; }
+
+	bool operator()(const Vector2& lhs, const Vector2& rhs) const;
+	bool operator()(const Vector3& lhs, const Vector3& rhs) const;
+	bool operator()(const Vector4& lhs, const Vector4& rhs) const;
+
+	float cellSize;
+};
+
+//Component access and cell hashing shared by the policies and VectorMap
+template <typename Vector>
+struct VectorTraits;
+
+template <>
+struct VectorTraits<Vector2>
+{
+	static constexpr int dimensions = 2;
+	static float Get(const Vector2& vector, const int index) { return index == 0 ? vector.x : vector.y; }
+};
+
+template <>
+struct VectorTraits<Vector3>
+{
+	static constexpr int dimensions = 3;
+	static float Get(const Vector3& vector, const int index) { return vector[index]; }
+};
+
+template <>
+struct VectorTraits<Vector4>
+{
+	static constexpr int dimensions = 4;
+	static float Get(const Vector4& vector, const int index) { return index == 0 ? vector.x : index == 1 ? vector.y : index == 2 ? vector.z : vector.w; }
+};
+
+struct VectorCells
+{
+	//Returns grid cell of value, NaN goes to the lowest cell
+	//Values more than 2^62 cells away from the origin each get a cell of their own, floats are farther apart than a cell there
+	static int64_t Cell(float value, double inverseCellSize);
+
+	//Returns grid cell of value like Cell, fraction is the position of value inside the cell in [0, 1) and 0 for NaN and for values with a cell of their own
+	static int64_t Cell(double& fraction, float value, double inverseCellSize);
+
+	//Mixes cell coordinates into a 64 bit hash
+	static uint64_t Hash(const int64_t* cells, int dimensions);
+};
+
+//Open addressing hash map whose keys are vectors and whose lookups match any key within epsilon
+//Keys are hashed by their grid cell of twice epsilon, so a key within epsilon is in the cell of the query or in a neighbour on the near side of each axis
+//A lookup probes at most 2^d cells and skips neighbours farther away than epsilon, most lookups touch one or two cells
+//Entries are stored densely in insertion order and never move, their indices stay valid until Clear
+//Caution: Matching is first come, a key is merged into the first stored key within epsilon, not into the closest one !
+template <typename Vector, typename Value>
+class VectorMap
+{
+public:
+	struct Entry
+	{
+		Vector key;
+		Value value;
+	};
+
+	static constexpr uint32_t invalid = 0xFFFFFFFF;
+
+	//Epsilon of zero matches keys equal by VectorEqual only
+	explicit VectorMap(const float epsilon, const size_t expectedCount = 0) : epsilon(epsilon)
+	{
+		//Cells are a hair larger than twice epsilon, so rounding never puts keys within epsilon two cells apart
+		inverseCellSize = epsilon > 0 ? 1 / (2.0 * epsilon) * (1 - 1e-9) : 1;
+		Reserve(expectedCount);
+	}
+
+	//Inserts key unless a key within epsilon exists, index is set to the entry of either
+	//Returns true if a new entry was inserted
+	bool Insert(uint32_t& index, const Vector& key, const Value& value = Value())
+	{
+		uint64_t hash;
+		index = Find(hash, key);
+		if (index != invalid) return false;
+
+		if ((entries.size() + 1) * 2 > slots.size()) Grow((entries.size() + 1) * 2);
+
+		index = static_cast<uint32_t>(entries.size());
+		entries.push_back({ key, value });
+		Place(index, hash);
+		return true;
+	}
+
+	//Returns index of a key within epsilon, or invalid if there is none
+	[[nodiscard]]
+	uint32_t Find(const Vector& key) const
+	{
+		uint64_t hash;
+		return Find(hash, key);
+	}
+
+	//Returns value of a key within epsilon, or nullptr if there is none
+	[[nodiscard]]
+	Value* Get(const Vector& key)
+	{
+		const uint32_t index = Find(key);
+		return index == invalid ? nullptr : &entries[index].value;
+	}
+
+	[[nodiscard]]
+	const std::vector<Entry>& Entries() const
+	{
+		return entries;
+	}
+
+	[[nodiscard]]
+	size_t Size() const
+	{
+		return entries.size();
+	}
+
+	[[nodiscard]]
+	float Epsilon() const
+	{
+		return epsilon;
+	}
+
+	void Reserve(const size_t count)
+	{
+		entries.reserve(count);
+		if (count * 2 > slots.size()) Grow(count * 2);
+	}
+
+	void Clear()
+	{
+		entries.clear();
+		std::fill(slots.begin(), slots.end(), Slot{ invalid, 0 });
+	}
+
+private:
+	static constexpr int dimensions = VectorTraits<Vector>::dimensions;
+
+	//Upper half of the cell hash is kept next to the entry, so probing only reads entries of the probed cell
+	struct Slot
+	{
+		uint32_t entry;
+		uint32_t tag;
+	};
+
+	//In double, so squares of differences between tiny floats do not underflow to zero
+	static double SqrDistance(const Vector& lhs, const Vector& rhs)
+	{
+		double result = 0;
+		for (int axis = 0; axis < dimensions; axis++)
+		{
+			const double difference = static_cast<double>(VectorTraits<Vector>::Get(lhs, axis)) - VectorTraits<Vector>::Get(rhs, axis);
+			result += difference * difference;
+		}
+		return result;
+	}
+
+	bool Matches(const Vector& stored, const Vector& key) const
+	{
+		if (epsilon > 0) return SqrDistance(stored, key) <= static_cast<double>(epsilon) * epsilon;
+		return VectorEqual()(stored, key);
+	}
+
+	//Returns index of a key within epsilon, or invalid if there is none, hash is set to the cell hash of key
+	uint32_t Find(uint64_t& hash, const Vector& key) const
+	{
+		int64_t base[dimensions];
+		//Neighbour cell on the near side of each axis and the squared distance of key to it
+		int64_t side[dimensions];
+		double sideSqrDistance[dimensions];
+		const double cellSize = 1 / inverseCellSize;
+		for (int axis = 0; axis < dimensions; axis++)
+		{
+			double fraction;
+			base[axis] = VectorCells::Cell(fraction, VectorTraits<Vector>::Get(key, axis), inverseCellSize);
+			side[axis] = fraction < 0.5 ? -1 : 1;
+			const double distance = (fraction < 0.5 ? fraction : 1 - fraction) * cellSize;
+			sideSqrDistance[axis] = distance * distance;
+		}
+
+		hash = VectorCells::Hash(base, dimensions);
+		if (entries.empty()) return invalid;
+
+		const double sqrEpsilon = static_cast<double>(epsilon) * epsilon;
+		const int neighbours = epsilon > 0 ? 1 << dimensions : 1;
+		uint64_t cellHashes[1 << dimensions];
+		int cellCount = 0;
+		for (int neighbour = 0; neighbour < neighbours; neighbour++)
+		{
+			//Bit i of neighbour selects the near side neighbour on axis i
+			int64_t cell[dimensions];
+			double cellSqrDistance = 0;
+			for (int axis = 0; axis < dimensions; axis++)
+			{
+				const bool offset = (neighbour >> axis & 1) != 0;
+				cell[axis] = offset ? base[axis] + side[axis] : base[axis];
+				if (offset) cellSqrDistance += sideSqrDistance[axis];
+			}
+			if (cellSqrDistance > sqrEpsilon * (1 + 1e-6)) continue;
+
+			const uint64_t cellHash = neighbour == 0 ? hash : VectorCells::Hash(cell, dimensions);
+			cellHashes[cellCount++] = cellHash;
+#ifdef VECTOR_HASH_SSE
+			//Probed cells are scattered over the whole table, fetching them all up front overlaps their cache misses
+			_mm_prefetch(reinterpret_cast<const char*>(&slots[cellHash & mask]), _MM_HINT_T0);
+#endif
+		}
+
+		for (int cell = 0; cell < cellCount; cell++)
+		{
+			const uint32_t tag = static_cast<uint32_t>(cellHashes[cell] >> 32);
+			for (size_t slot = cellHashes[cell] & mask;; slot = (slot + 1) & mask)
+			{
+				const Slot& probe = slots[slot];
+				if (probe.entry == invalid) break;
+				if (probe.tag == tag && Matches(entries[probe.entry].key, key)) return probe.entry;
+			}
+		}
+
+		return invalid;
+	}
+
+	uint64_t CellHash(const Vector& key) const
+	{
+		int64_t cells[dimensions];
+		for (int axis = 0; axis < dimensions; axis++)
+			cells[axis] = VectorCells::Cell(VectorTraits<Vector>::Get(key, axis), inverseCellSize);
+		return VectorCells::Hash(cells, dimensions);
+	}
+
+	void Place(const uint32_t entry, const uint64_t hash)
+	{
+		size_t slot = hash & mask;
+		while (slots[slot].entry != invalid)
+			slot = (slot + 1) & mask;
+		slots[slot] = { entry, static_cast<uint32_t>(hash >> 32) };
+	}
+
+	//Slot count stays a power of two at least twice the entry count, so probe chains stay short
+	void Grow(const size_t minimum)
+	{
+		size_t count = 16;
+		while (count < minimum)
+			count <<= 1;
+		if (count <= slots.size()) return;
+
+		slots.assign(count, Slot{ invalid, 0 });
+		mask = count - 1;
+		for (uint32_t entry = 0; entry < entries.size(); entry++)
+			Place(entry, CellHash(entries[entry].key));
+	}
+
+	float epsilon;
+	double inverseCellSize;
+	std::vector<Entry> entries;
+	std::vector<Slot> slots;
+	size_t mask = 0;
+};
+
+struct VectorSetValue
+{
+};
+
+//Set of vectors that treats keys within epsilon as the same key
+template <typename Vector>
+using VectorSet = VectorMap<Vector, VectorSetValue>;
+
+struct VectorWeld
+{
+	//Merges points within epsilon of an earlier point, unique gets the first point of every group and remap[i] the index of point i in unique
+	template <typename Vector>
+	static void Weld(std::vector<Vector>& unique, std::vector<uint32_t>& remap, const Vector* points, const size_t count, const float epsilon)
+	{
+		VectorSet<Vector> set(epsilon, count);
+		remap.resize(count);
+		for (size_t i = 0; i < count; i++)
+			set.Insert(remap[i], points[i]);
+
+		unique.clear();
+		unique.reserve(set.Size());
+		for (const typename VectorSet<Vector>::Entry& entry : set.Entries())
+			unique.push_back(entry.key);
+	}
+};
+
+//Exact hashing for the standard containers, use VectorEqual as their key equality
+namespace std
+{
+	template <>
+	struct hash<Vector2>
+	{
+		size_t operator()(const Vector2& vector) const { return VectorHash()(vector); }
+	};
+
+	template <>
+	struct hash<Vector3>
+	{
+		size_t operator()(const Vector3& vector) const { return VectorHash()(vector); }
+	};
+
+	template <>
+	struct hash<Vector4>
+	{
+		size_t operator()(const Vector4& vector) const { return VectorHash()(vector); }
+	};
+}
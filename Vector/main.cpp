@@ -2,8 +2,26 @@
 
 // PVS-Studio Static Code Analyzer for C, C++, C#, and Java: http://www.viva64.com
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+#include "Accuracy.h"
+#include "Broadphase.h"
+#include "ClosestPoint.h"
+#include "ConcurrentGrid.h"
+#include "ContinuousCollision.h"
+#include "ConvexHull.h"
+#include "Predicates.h"
+#include "RayStream.h"
+#include "SegmentIntersection.h"
+#include "SharedPool.h"
+#include "Spline.h"
 #include "Vector.h"
+#include "VectorBatch.h"
+#include "VectorHash.h"
 
 int main()
 {	
@@ -34,6 +52,866 @@ int main()
 
 	if (intersect) std::cout << "Line intersects triangle at: " << intersection.ToString() << "\n";
 	
+	std::cout << "\n\n";
+
+	//Packet traversal of RayStream against BVH::Raycast on a random triangle soup and on axis aligned rays that start on a face of the bounds of a single triangle
+	//Rays parallel to a slab whose origin lies on its plane give 0 * inf in the slab test, both traversals have to skip that slab the same way
+	const auto rayStreamMismatches = [](const std::vector<Vector3>& vertices, const std::vector<Vector3>& directions, const std::vector<Vector3>& origins)
+	{
+		BVH tree;
+		tree.Build(vertices.data(), vertices.size() / 3);
+		RayStream stream(1.0f);
+		stream.Sort(directions.data(), origins.data(), directions.size());
+		std::vector<BVH::RaycastHit> hits;
+		std::vector<uint8_t> found;
+		stream.Trace(hits, found, tree, vertices.data());
+
+		size_t mismatches = 0;
+		for (size_t i = 0; i < directions.size(); i++)
+		{
+			BVH::RaycastHit hit;
+			const bool expected = tree.Raycast(hit, vertices.data(), directions[i], origins[i]);
+			if (expected != (found[i] != 0) || (expected && (hit.triangle != hits[i].triangle || hit.distance != hits[i].distance))) mismatches++;
+		}
+		return mismatches;
+	};
+
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> coordinate(-10, 10);
+	std::vector<Vector3> soup, directions, origins;
+	for (int i = 0; i < 3 * 2000; i++)
+		soup.push_back(Vector3(coordinate(random), coordinate(random), coordinate(random)));
+	for (int i = 0; i < 20000; i++)
+	{
+		directions.push_back(Vector3(coordinate(random), coordinate(random), coordinate(random)).Normalize());
+		origins.push_back(Vector3(coordinate(random), coordinate(random), coordinate(random)));
+	}
+	std::cout << "RayStream mismatches against BVH::Raycast, random rays: " << rayStreamMismatches(soup, directions, origins) << " of " << directions.size() << "\n";
+
+	//Triangle in z = 5, rays along z start on the x = 0 face of its bounds and rays along x start in its z = 5 plane
+	const std::vector<Vector3> triangle = { Vector3(0, 0, 5), Vector3(2, 0, 5), Vector3(0, 2, 5) };
+	directions.clear();
+	origins.clear();
+	for (int i = 0; i < 8; i++)
+	{
+		directions.push_back(Vector3(0, 0, 1));
+		origins.push_back(Vector3(0, 0.1f + 0.2f * i, 0));
+		directions.push_back(Vector3(1, 0, 0));
+		origins.push_back(Vector3(-5, 0.1f + 0.2f * i, 5));
+	}
+	std::cout << "RayStream mismatches against BVH::Raycast, rays on faces: " << rayStreamMismatches(triangle, directions, origins) << " of " << directions.size() << "\n";
+
+	//Every VectorBatch path against the scalar path on huge, ordinary and tiny vectors, where reciprocal estimates of the wider paths leave their range
+	for (const float scale : { 1e19f, 1.0f, 1e-19f })
+	{
+		std::uniform_real_distribution<float> component(-1, 1);
+		const size_t count = 1000;
+		std::vector<float> components(count * 6), expected2(count), expected3(count), angles(count);
+		for (float& value : components)
+			value = component(random) * scale;
+		const float* c = components.data();
+		const Vector2Soa<const float> from2(c, c + count), to2(c + 2 * count, c + 3 * count);
+		const Vector3Soa<const float> from3(c, c + count, c + 2 * count), to3(c + 3 * count, c + 4 * count, c + 5 * count);
+
+		const VectorBatch::Path previous = VectorBatch::ActivePath();
+		VectorBatch::SetPath(VectorBatch::Path::Scalar);
+		VectorBatch::Angle(expected2.data(), from2, to2, count);
+		VectorBatch::Angle(expected3.data(), from3, to3, count);
+
+		std::cout << "VectorBatch::Angle largest difference from the scalar path at scale " << scale << ":";
+		for (int path = static_cast<int>(VectorBatch::Path::SSE); path <= static_cast<int>(VectorBatch::SupportedPath()); path++)
+		{
+			VectorBatch::SetPath(static_cast<VectorBatch::Path>(path));
+			float difference = 0;
+			VectorBatch::Angle(angles.data(), from2, to2, count);
+			for (size_t i = 0; i < count; i++)
+				difference = std::max(difference, std::isnan(angles[i]) != std::isnan(expected2[i]) ? INFINITY : std::fabs(angles[i] - expected2[i]));
+			VectorBatch::Angle(angles.data(), from3, to3, count);
+			for (size_t i = 0; i < count; i++)
+				difference = std::max(difference, std::isnan(angles[i]) != std::isnan(expected3[i]) ? INFINITY : std::fabs(angles[i] - expected3[i]));
+			std::cout << " " << VectorBatch::PathName(static_cast<VectorBatch::Path>(path)) << " " << difference;
+		}
+		std::cout << " degrees\n";
+		VectorBatch::SetPath(previous);
+	}
+
+	//SweepAndPrune against testing every pair of boxes, over frames that move, resize, remove and add boxes
+	{
+		std::uniform_real_distribution<float> extent(-1, 1);
+		SweepAndPrune broadphase;
+		std::vector<uint32_t> handles;
+		for (int i = 0; i < 500; i++)
+			handles.push_back(broadphase.Add(Vector3(coordinate(random), coordinate(random), coordinate(random)), Vector3(extent(random), extent(random), extent(random))));
+
+		size_t mismatches = 0;
+		const int frames = 50;
+		for (int frame = 0; frame < frames; frame++)
+		{
+			for (size_t i = 0; i < handles.size(); i++)
+			{
+				if (random() % 4 == 0) broadphase.Update(handles[i], Vector3(coordinate(random), coordinate(random), coordinate(random)), Vector3(extent(random), extent(random), extent(random)));
+			}
+			for (int i = 0; i < 10; i++)
+			{
+				const size_t index = random() % handles.size();
+				broadphase.Remove(handles[index]);
+				handles[index] = handles.back();
+				handles.pop_back();
+				handles.push_back(broadphase.Add(Vector3(coordinate(random), coordinate(random), coordinate(random)), Vector3(extent(random), extent(random), extent(random))));
+			}
+
+			std::vector<std::pair<uint32_t, uint32_t>> found, expected;
+			for (const SweepAndPrune::Pair& pair : broadphase.FindPairs())
+				found.emplace_back(pair.a, pair.b);
+			for (size_t i = 0; i < handles.size(); i++)
+			{
+				for (size_t j = i + 1; j < handles.size(); j++)
+				{
+					const Bounds& a = broadphase.GetBounds(handles[i]);
+					const Bounds& b = broadphase.GetBounds(handles[j]);
+					bool overlap = true;
+					for (int axis = 0; axis < 3; axis++)
+						overlap = overlap && a.min[axis] <= b.max[axis] && b.min[axis] <= a.max[axis];
+					if (overlap) expected.emplace_back(std::min(handles[i], handles[j]), std::max(handles[i], handles[j]));
+				}
+			}
+			std::sort(found.begin(), found.end());
+			std::sort(expected.begin(), expected.end());
+			if (found != expected) mismatches++;
+		}
+		std::cout << "SweepAndPrune frames whose pairs differ from brute force: " << mismatches << " of " << frames << "\n";
+	}
+
+	//ConvexHull against the definition of a hull, every input point has to be on the inner side or on every edge or face
+	//Random points, points on a circle or sphere and points on a grid, where most points are collinear or coplanar
+	{
+		std::vector<std::vector<Vector2>> sets2;
+		std::vector<std::vector<Vector3>> sets3;
+		sets2.emplace_back();
+		sets3.emplace_back();
+		for (int i = 0; i < 100000; i++)
+		{
+			sets2.back().push_back(Vector2(coordinate(random), coordinate(random)));
+			sets3.back().push_back(Vector3(coordinate(random), coordinate(random), coordinate(random)));
+		}
+		sets2.emplace_back();
+		sets3.emplace_back();
+		for (int i = 0; i < 2000; i++)
+		{
+			sets2.back().push_back(Vector2(coordinate(random), coordinate(random)).Normalize() * 10);
+			sets3.back().push_back(Vector3(coordinate(random), coordinate(random), coordinate(random)).Normalize() * 10);
+		}
+		sets2.emplace_back();
+		sets3.emplace_back();
+		for (int x = 0; x < 20; x++)
+		{
+			for (int y = 0; y < 20; y++)
+			{
+				sets2.back().push_back(Vector2(x, y));
+				for (int z = 0; z < 20; z++)
+					sets3.back().push_back(Vector3(x, y, z));
+			}
+		}
+
+		size_t failures = 0;
+		for (const std::vector<Vector2>& points : sets2)
+		{
+			std::vector<uint32_t> hull;
+			ConvexHull::Quickhull(points.data(), points.size(), hull);
+			std::vector<uint32_t> sorted = hull;
+			std::sort(sorted.begin(), sorted.end());
+			bool valid = hull.size() >= 3 && std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end();
+			for (size_t i = 0; valid && i < hull.size(); i++)
+			{
+				const Vector2& a = points[hull[i]];
+				const Vector2& b = points[hull[(i + 1) % hull.size()]];
+				valid = Predicates::Orient2D(a, b, points[hull[(i + 2) % hull.size()]]) > 0;
+				for (const Vector2& p : points)
+					valid = valid && Predicates::Orient2D(a, b, p) >= 0;
+			}
+			if (!valid) failures++;
+		}
+		std::cout << "ConvexHull 2D hulls failing the brute force edge test: " << failures << " of " << sets2.size() << "\n";
+
+		failures = 0;
+		for (const std::vector<Vector3>& points : sets3)
+		{
+			std::vector<uint32_t> vertices, triangles;
+			bool valid = ConvexHull::Quickhull(points.data(), points.size(), vertices, triangles);
+
+			//Closed surface: every directed edge is used once and its reverse once, and Euler characteristic is 2
+			std::vector<std::pair<uint32_t, uint32_t>> edges, reversed;
+			for (size_t t = 0; t < triangles.size(); t += 3)
+			{
+				for (int e = 0; e < 3; e++)
+				{
+					edges.emplace_back(triangles[t + e], triangles[t + (e + 1) % 3]);
+					reversed.emplace_back(triangles[t + (e + 1) % 3], triangles[t + e]);
+				}
+			}
+			std::sort(edges.begin(), edges.end());
+			std::sort(reversed.begin(), reversed.end());
+			valid = valid && edges == reversed && std::adjacent_find(edges.begin(), edges.end()) == edges.end();
+			valid = valid && vertices.size() + triangles.size() / 3 == edges.size() / 2 + 2;
+
+			for (size_t t = 0; valid && t < triangles.size(); t += 3)
+			{
+				for (const Vector3& p : points)
+					valid = valid && Predicates::Orient3D(points[vertices[triangles[t]]], points[vertices[triangles[t + 1]]], points[vertices[triangles[t + 2]]], p) <= 0;
+			}
+			if (!valid) failures++;
+		}
+		std::cout << "ConvexHull 3D hulls failing the brute force face test: " << failures << " of " << sets3.size() << "\n";
+	}
+
+	//BVH and DynamicBVH against testing every triangle, raycasts have to find the nearest hit in front of the origin and Overlap may not miss a triangle
+	{
+		const auto nearestHit = [](BVH::RaycastHit& hit, const std::vector<Vector3>& vertices, const Vector3& direction, const Vector3& origin)
+		{
+			bool found = false;
+			for (uint32_t triangle = 0; triangle < vertices.size() / 3; triangle++)
+			{
+				Vector3 point;
+				if (!Vector3::LineTriangleIntersection(point, direction, origin, vertices[triangle * 3], vertices[triangle * 3 + 1], vertices[triangle * 3 + 2])) continue;
+				const float distance = Vector3::Dot(point - origin, direction);
+				if (distance >= 0 && (!found || distance < hit.distance))
+				{
+					hit.distance = distance;
+					hit.triangle = triangle;
+					found = true;
+				}
+			}
+			return found;
+		};
+		const auto raycastMismatch = [&nearestHit](const bool found, const BVH::RaycastHit& hit, const std::vector<Vector3>& vertices, const Vector3& direction, const Vector3& origin)
+		{
+			BVH::RaycastHit expected;
+			const bool expectedFound = nearestHit(expected, vertices, direction, origin);
+			return found != expectedFound || (found && hit.distance != expected.distance);
+		};
+
+		BVH tree;
+		tree.Build(soup.data(), soup.size() / 3);
+		size_t mismatches = 0;
+		const size_t rays = 2000;
+		for (size_t i = 0; i < rays; i++)
+		{
+			const Vector3 direction = Vector3(coordinate(random), coordinate(random), coordinate(random)).Normalize();
+			const Vector3 origin(coordinate(random), coordinate(random), coordinate(random));
+			BVH::RaycastHit hit;
+			const bool found = tree.Raycast(hit, soup.data(), direction, origin);
+			if (raycastMismatch(found, hit, soup, direction, origin)) mismatches++;
+		}
+		std::cout << "BVH::Raycast mismatches against brute force: " << mismatches << " of " << rays << "\n";
+
+		size_t missed = 0;
+		const size_t queries = 500;
+		for (size_t i = 0; i < queries; i++)
+		{
+			const Vector3 center(coordinate(random), coordinate(random), coordinate(random));
+			const Bounds box = Bounds::FromCenterExtents(center, Vector3(1, 1, 1));
+			std::vector<uint32_t> found;
+			tree.Overlap(box, found);
+			std::sort(found.begin(), found.end());
+			for (uint32_t triangle = 0; triangle < soup.size() / 3; triangle++)
+			{
+				const Bounds triangleBounds = Bounds::FromTriangle(soup[triangle * 3], soup[triangle * 3 + 1], soup[triangle * 3 + 2]);
+				if (Bounds::Overlaps(triangleBounds, box) && !std::binary_search(found.begin(), found.end(), triangle)) missed++;
+			}
+		}
+		std::cout << "BVH::Overlap triangles missed against brute force: " << missed << " in " << queries << " queries\n";
+
+		//Triangles move every frame, refits, rotations and background rebuilds all have to keep the published tree exact
+		//Small triangles, so moving them changes the tree cost enough to start rebuilds
+		std::uniform_real_distribution<float> step(-0.5f, 0.5f);
+		std::vector<Vector3> moving;
+		for (int i = 0; i < 2000; i++)
+		{
+			const Vector3 base(coordinate(random), coordinate(random), coordinate(random));
+			moving.push_back(base);
+			moving.push_back(base + Vector3(step(random), step(random), step(random)));
+			moving.push_back(base + Vector3(step(random), step(random), step(random)));
+		}
+		DynamicBVH dynamic(1.2f);
+		dynamic.Build(moving.data(), moving.size() / 3);
+		mismatches = 0;
+		const int frames = 300;
+		for (int frame = 0; frame < frames; frame++)
+		{
+			for (int i = 0; i < 50; i++)
+			{
+				const uint32_t triangle = random() % (moving.size() / 3);
+				const Vector3 offset(step(random), step(random), step(random));
+				for (int v = 0; v < 3; v++)
+					moving[triangle * 3 + v] = moving[triangle * 3 + v] + offset;
+				dynamic.SetTriangle(triangle, moving[triangle * 3], moving[triangle * 3 + 1], moving[triangle * 3 + 2]);
+			}
+			dynamic.Update();
+
+			const std::shared_ptr<const DynamicBVH::Snapshot> snapshot = dynamic.Acquire();
+			for (int i = 0; i < 10; i++)
+			{
+				const Vector3 direction = Vector3(coordinate(random), coordinate(random), coordinate(random)).Normalize();
+				const Vector3 origin(coordinate(random), coordinate(random), coordinate(random));
+				BVH::RaycastHit hit;
+				const bool found = snapshot->Raycast(hit, direction, origin);
+				if (raycastMismatch(found, hit, moving, direction, origin)) mismatches++;
+			}
+		}
+		std::cout << "DynamicBVH raycast mismatches against brute force: " << mismatches << " of " << frames * 10 << " over " << frames << " frames, " << dynamic.RebuildCount() << " rebuilds\n";
+	}
+
+	//SegmentIntersection::Sweep and BruteForce against calling Intersect on every pair, on random segments and on segments
+	//that share endpoints, overlap collinearly or all pass through one point
+	{
+		std::vector<std::vector<Vector2>> sets(3);
+		for (int i = 0; i < 2 * 1000; i++)
+			sets[0].push_back(Vector2(coordinate(random), coordinate(random)));
+		for (int x = 0; x < 8; x++)
+		{
+			for (int y = 0; y < 8; y++)
+			{
+				sets[1].push_back(Vector2(x, y));
+				sets[1].push_back(Vector2(x + 1, y));
+				sets[1].push_back(Vector2(x, y));
+				sets[1].push_back(Vector2(x + 2, y + 1));
+				sets[1].push_back(Vector2(0, y));
+				sets[1].push_back(Vector2(x, y));
+			}
+		}
+		for (int i = 0; i < 200; i++)
+		{
+			const Vector2 direction = Vector2(coordinate(random), coordinate(random));
+			sets[2].push_back(Vector2(1, 1) + direction);
+			sets[2].push_back(Vector2(1, 1) - direction * 0.5f);
+		}
+
+		const auto pairsOf = [](const std::vector<SegmentIntersection::Hit>& hits)
+		{
+			std::vector<std::pair<uint32_t, uint32_t>> pairs;
+			for (const SegmentIntersection::Hit& hit : hits)
+				pairs.emplace_back(hit.first, hit.second);
+			std::sort(pairs.begin(), pairs.end());
+			return pairs;
+		};
+
+		size_t sweepFailures = 0, bruteForceFailures = 0;
+		for (const std::vector<Vector2>& points : sets)
+		{
+			const size_t segments = points.size() / 2;
+			std::vector<std::pair<uint32_t, uint32_t>> expected;
+			for (uint32_t i = 0; i < segments; i++)
+			{
+				for (uint32_t j = i + 1; j < segments; j++)
+				{
+					Vector2 point;
+					if (SegmentIntersection::Intersect(point, points[i * 2], points[i * 2 + 1], points[j * 2], points[j * 2 + 1])) expected.emplace_back(i, j);
+				}
+			}
+
+			std::vector<SegmentIntersection::Hit> sweep, bruteForce;
+			SegmentIntersection::Sweep(points.data(), segments, [&sweep](const SegmentIntersection::Hit& hit) { sweep.push_back(hit); });
+			SegmentIntersection::BruteForce(points.data(), segments, [&bruteForce](const SegmentIntersection::Hit& hit) { bruteForce.push_back(hit); });
+			if (pairsOf(sweep) != expected) sweepFailures++;
+			if (pairsOf(bruteForce) != expected) bruteForceFailures++;
+		}
+		std::cout << "SegmentIntersection inputs whose pairs differ from testing every pair: Sweep " << sweepFailures << ", BruteForce " << bruteForceFailures << " of " << sets.size() << "\n";
+	}
+
+	//Spline batch evaluation against de Casteljau's algorithm with nested LerpNoClamp calls, and Catmull-Rom against the points it has to pass through
+	{
+		std::vector<Vector3> controls;
+		for (int i = 0; i < 3 * 200 + 1; i++)
+			controls.push_back(Vector3(coordinate(random), coordinate(random), coordinate(random)));
+		const Spline<Vector3> bezier = Spline<Vector3>::Bezier(controls.data(), controls.size());
+		const size_t pieces = bezier.Pieces().size();
+
+		std::uniform_real_distribution<float> unit(0, 1);
+		std::vector<float> parameters(50000);
+		for (float& u : parameters)
+			u = unit(random);
+		std::sort(parameters.begin(), parameters.end());
+		std::vector<Vector3> evaluated(parameters.size());
+		bezier.Evaluate(parameters.data(), parameters.size(), evaluated.data());
+
+		float bezierDifference = 0;
+		for (size_t i = 0; i < parameters.size(); i++)
+		{
+			const size_t piece = std::min(static_cast<size_t>(parameters[i] * pieces), pieces - 1);
+			const float t = parameters[i] * pieces - piece;
+			const Vector3* p = controls.data() + piece * 3;
+			const Vector3 a = Vector3::LerpNoClamp(p[0], p[1], t), b = Vector3::LerpNoClamp(p[1], p[2], t), c = Vector3::LerpNoClamp(p[2], p[3], t);
+			const Vector3 expected = Vector3::LerpNoClamp(Vector3::LerpNoClamp(a, b, t), Vector3::LerpNoClamp(b, c, t), t);
+			bezierDifference = std::max(bezierDifference, Vector3::Distance(evaluated[i], expected));
+		}
+
+		const Spline<Vector3> catmullRom = Spline<Vector3>::CatmullRom(controls.data(), controls.size());
+		float catmullRomDifference = 0;
+		for (size_t i = 0; i < catmullRom.Pieces().size(); i++)
+		{
+			catmullRomDifference = std::max(catmullRomDifference, Vector3::Distance(catmullRom.Pieces()[i].Evaluate(0.0f), controls[i]));
+			catmullRomDifference = std::max(catmullRomDifference, Vector3::Distance(catmullRom.Pieces()[i].Evaluate(1.0f), controls[i + 1]));
+		}
+
+		std::cout << "Spline::Evaluate largest distance from de Casteljau: " << bezierDifference << ", Catmull-Rom largest distance from its points: " << catmullRomDifference << "\n";
+	}
+
+	//ClosestPoint against dense sampling of each shape, the reported distance may not be larger than the closest sample and the reported point has to lie on the shape at that distance
+	//One query in eight uses a degenerate segment or triangle, batch versions are compared with the scalar ones and PointMesh with and without a tree
+	{
+		const float tolerance = 1e-4f;
+		const auto consistent = [tolerance](const float sqrDistance, const float sampled, const Vector3& closest, const Vector3& point, const bool onShape)
+		{
+			return onShape && sqrDistance <= sampled * (1 + tolerance) + tolerance && std::fabs((closest - point).SqrMagnitude() - sqrDistance) <= tolerance * (1 + sqrDistance);
+		};
+		const auto onSegment = [tolerance](const Vector3& p, const Vector3& a, const Vector3& b)
+		{
+			return Vector3::Distance(p, a) + Vector3::Distance(p, b) <= Vector3::Distance(a, b) + tolerance;
+		};
+		const auto onTriangle = [tolerance](const Vector3& p, const Vector3& a, const Vector3& b, const Vector3& c)
+		{
+			const float area = Vector3::Cross(b - a, c - a).Magnitude();
+			return Vector3::Cross(a - p, b - p).Magnitude() + Vector3::Cross(b - p, c - p).Magnitude() + Vector3::Cross(c - p, a - p).Magnitude() <= area + tolerance * 100;
+		};
+		const auto randomPoint = [&]() { return Vector3(coordinate(random), coordinate(random), coordinate(random)); };
+
+		const int queries = 500;
+		const int samples = 200;
+		size_t segmentFailures = 0, triangleFailures = 0, segmentSegmentFailures = 0, boundsFailures = 0;
+		for (int query = 0; query < queries; query++)
+		{
+			const Vector3 point = randomPoint(), a = randomPoint(), b = query % 8 == 0 ? a : randomPoint();
+			const Vector3 c = query % 8 == 1 ? Vector3::LerpNoClamp(a, b, 2.0f) : randomPoint();
+
+			Vector3 closest;
+			float sqrDistance = ClosestPoint::PointSegment(closest, point, a, b);
+			float sampled = INFINITY;
+			for (int i = 0; i <= samples; i++)
+				sampled = std::min(sampled, (Vector3::LerpNoClamp(a, b, static_cast<float>(i) / samples) - point).SqrMagnitude());
+			if (!consistent(sqrDistance, sampled, closest, point, onSegment(closest, a, b))) segmentFailures++;
+
+			sqrDistance = ClosestPoint::PointTriangle(closest, point, a, b, c);
+			sampled = INFINITY;
+			for (int i = 0; i <= samples; i++)
+			{
+				for (int j = 0; i + j <= samples; j++)
+				{
+					const float u = static_cast<float>(i) / samples, v = static_cast<float>(j) / samples;
+					sampled = std::min(sampled, (a + (b - a) * u + (c - a) * v - point).SqrMagnitude());
+				}
+			}
+			if (!consistent(sqrDistance, sampled, closest, point, onTriangle(closest, a, b, c))) triangleFailures++;
+
+			const Vector3 q0 = randomPoint(), q1 = query % 8 == 2 ? q0 : randomPoint();
+			Vector3 closestQ;
+			sqrDistance = ClosestPoint::SegmentSegment(closest, closestQ, a, b, q0, q1);
+			sampled = INFINITY;
+			for (int i = 0; i <= samples; i++)
+				for (int j = 0; j <= samples; j++)
+					sampled = std::min(sampled, (Vector3::LerpNoClamp(a, b, static_cast<float>(i) / samples) - Vector3::LerpNoClamp(q0, q1, static_cast<float>(j) / samples)).SqrMagnitude());
+			if (!consistent(sqrDistance, sampled, closest, closestQ, onSegment(closest, a, b) && onSegment(closestQ, q0, q1))) segmentSegmentFailures++;
+
+			const Bounds bounds(Vector3(std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z)), Vector3(std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z)));
+			sqrDistance = ClosestPoint::PointBounds(closest, point, bounds);
+			sampled = INFINITY;
+			for (int i = 0; i <= 20; i++)
+				for (int j = 0; j <= 20; j++)
+					for (int k = 0; k <= 20; k++)
+						sampled = std::min(sampled, (Vector3(bounds.min.x + (bounds.max.x - bounds.min.x) * i / 20, bounds.min.y + (bounds.max.y - bounds.min.y) * j / 20, bounds.min.z + (bounds.max.z - bounds.min.z) * k / 20) - point).SqrMagnitude());
+			bool inside = true;
+			for (int axis = 0; axis < 3; axis++)
+				inside = inside && closest[axis] >= bounds.min[axis] && closest[axis] <= bounds.max[axis];
+			if (!consistent(sqrDistance, sampled, closest, point, inside)) boundsFailures++;
+		}
+		std::cout << "ClosestPoint queries failing against dense sampling: PointSegment " << segmentFailures << ", PointTriangle " << triangleFailures
+			<< ", SegmentSegment " << segmentSegmentFailures << ", PointBounds " << boundsFailures << " of " << queries << " each\n";
+
+		//Batches run four points at a time with SSE, they have to agree with the scalar queries up to rounding
+		std::vector<Vector3> points(1001);
+		for (Vector3& p : points)
+			p = randomPoint();
+		const Vector3 a = randomPoint(), b = randomPoint(), c = randomPoint();
+		const Bounds bounds = Bounds::FromCenterExtents(randomPoint(), Vector3(2, 3, 4));
+		std::vector<Vector3> closest(points.size()), closestQ(points.size());
+		std::vector<float> sqrDistances(points.size());
+		float largest = 0;
+		const auto compare = [&largest](const float batch, const float scalar)
+		{
+			largest = std::max(largest, std::isnan(batch) != std::isnan(scalar) ? INFINITY : std::fabs(batch - scalar) / std::max(1.0f, scalar));
+		};
+
+		ClosestPoint::PointSegment(closest.data(), sqrDistances.data(), points.data(), points.size(), a, b);
+		for (size_t i = 0; i < points.size(); i++)
+		{
+			Vector3 expected;
+			compare(sqrDistances[i], ClosestPoint::PointSegment(expected, points[i], a, b));
+		}
+		for (const Vector3& corner : { b, a })
+		{
+			ClosestPoint::PointTriangle(closest.data(), sqrDistances.data(), points.data(), points.size(), a, corner, c);
+			for (size_t i = 0; i < points.size(); i++)
+			{
+				Vector3 expected;
+				compare(sqrDistances[i], ClosestPoint::PointTriangle(expected, points[i], a, corner, c));
+			}
+		}
+		ClosestPoint::SegmentSegment(closest.data(), closestQ.data(), sqrDistances.data(), points.data(), points.size() / 2, a, b);
+		for (size_t i = 0; i < points.size() / 2; i++)
+		{
+			Vector3 expectedP, expectedQ;
+			compare(sqrDistances[i], ClosestPoint::SegmentSegment(expectedP, expectedQ, points[i * 2], points[i * 2 + 1], a, b));
+		}
+		ClosestPoint::PointBounds(closest.data(), sqrDistances.data(), points.data(), points.size(), bounds);
+		for (size_t i = 0; i < points.size(); i++)
+		{
+			Vector3 expected;
+			compare(sqrDistances[i], ClosestPoint::PointBounds(expected, points[i], bounds));
+		}
+		std::cout << "ClosestPoint batch largest relative difference from the scalar queries: " << largest << "\n";
+
+		//The tree path tests triangles with the scalar query, so it has to match a scalar loop exactly, the path without a tree runs four triangles at a time
+		BVH tree;
+		tree.Build(soup.data(), soup.size() / 3);
+		size_t treeMismatches = 0, batchMismatches = 0;
+		for (int query = 0; query < queries; query++)
+		{
+			const Vector3 point = randomPoint() * 1.5f;
+			float expected = INFINITY;
+			for (size_t triangle = 0; triangle < soup.size() / 3; triangle++)
+			{
+				Vector3 closestOnTriangle;
+				expected = std::min(expected, ClosestPoint::PointTriangle(closestOnTriangle, point, soup[triangle * 3], soup[triangle * 3 + 1], soup[triangle * 3 + 2]));
+			}
+
+			ClosestPoint::MeshHit withTree, withoutTree;
+			if (!ClosestPoint::PointMesh(withTree, point, soup.data(), soup.size() / 3, &tree) || withTree.sqrDistance != expected) treeMismatches++;
+			if (!ClosestPoint::PointMesh(withoutTree, point, soup.data(), soup.size() / 3) || std::fabs(withoutTree.sqrDistance - expected) > tolerance * std::max(1.0f, expected)) batchMismatches++;
+		}
+		std::cout << "ClosestPoint::PointMesh mismatches against testing every triangle: with a tree " << treeMismatches << ", without " << batchMismatches << " of " << queries << "\n";
+	}
+
+	//ContinuousCollision against stepping through the motion in small steps. A sphere contact may not come after the first step that touches, and only comes
+	//more than a step earlier when the motion grazes the triangle. A moving triangle contact has to be within two steps of the crossing. Batch queries have to match the earliest single query exactly
+	{
+		const int queries = 500;
+		const int steps = 4096;
+		std::uniform_real_distribution<float> unit(0, 1);
+		std::uniform_real_distribution<float> nearby(-5, 5);
+		const auto randomPoint = [&]() { return Vector3(coordinate(random), coordinate(random), coordinate(random)); };
+		const auto near = [&](const Vector3& center) { return center + Vector3(nearby(random), nearby(random), nearby(random)); };
+
+		size_t sphereFailures = 0, pointFailures = 0, sphereHits = 0, pointHits = 0;
+		std::vector<ContinuousCollision::Triangle> triangles;
+		std::vector<Vector3> from, to;
+		for (int query = 0; query < queries; query++)
+		{
+			const Vector3 start = randomPoint(), end = randomPoint();
+			const Vector3 passing = Vector3::LerpNoClamp(start, end, unit(random));
+			const Vector3 a = near(passing), b = near(passing), c = near(passing);
+			const float radius = 0.5f + unit(random);
+
+			//Sphere touches when the distance from its center to the triangle is at most its radius
+			ContinuousCollision::Contact contact;
+			bool hit = ContinuousCollision::SphereTriangle(contact, start, end, radius, a, b, c);
+			float firstTouch = INFINITY, nearest = INFINITY;
+			for (int step = 0; step <= steps; step++)
+			{
+				Vector3 closest;
+				const float distance = std::sqrt(ClosestPoint::PointTriangle(closest, Vector3::LerpNoClamp(start, end, static_cast<float>(step) / steps), a, b, c));
+				nearest = std::min(nearest, distance);
+				if (distance <= radius)
+				{
+					firstTouch = static_cast<float>(step) / steps;
+					break;
+				}
+			}
+			if (hit) sphereHits++;
+			if (hit ? contact.time > firstTouch + 1e-5f || (contact.time < firstTouch - 1.0f / steps - 1e-5f && nearest > radius * 1.001f) : firstTouch <= 1) sphereFailures++;
+
+			const Vector3 a1 = near(a), b1 = near(b), c1 = near(c);
+			hit = ContinuousCollision::PointMovingTriangle(contact, start, end, a, b, c, a1, b1, c1);
+			//The plane moves too, so a crossing is a sign change of the distance to the plane at that time, and the point has to be on the triangle there
+			const auto triangleAt = [&](const float t, Vector3& ta, Vector3& tb, Vector3& tc)
+			{
+				ta = Vector3::LerpNoClamp(a, a1, t);
+				tb = Vector3::LerpNoClamp(b, b1, t);
+				tc = Vector3::LerpNoClamp(c, c1, t);
+			};
+			const auto planeDistance = [&](const float t)
+			{
+				Vector3 ta, tb, tc;
+				triangleAt(t, ta, tb, tc);
+				return Vector3::Dot(Vector3::LerpNoClamp(start, end, t) - ta, Vector3::Cross(tb - ta, tc - ta).Normalize());
+			};
+			firstTouch = INFINITY;
+			float previous = planeDistance(0);
+			for (int step = 1; step <= steps && firstTouch > 1; step++)
+			{
+				const float t1 = static_cast<float>(step) / steps;
+				const float current = planeDistance(t1);
+				if ((previous <= 0) != (current <= 0))
+				{
+					const float t = t1 - (1.0f / steps) * current / (current - previous);
+					Vector3 ta, tb, tc, closest;
+					triangleAt(t, ta, tb, tc);
+					if (ClosestPoint::PointTriangle(closest, Vector3::LerpNoClamp(start, end, t), ta, tb, tc) <= 1e-4f) firstTouch = t;
+				}
+				previous = current;
+			}
+			if (hit) pointHits++;
+			if (hit != (firstTouch <= 1) || (hit && std::fabs(contact.time - firstTouch) > 2.0f / steps)) pointFailures++;
+
+			triangles.push_back(ContinuousCollision::Triangle(a, b, c));
+			from.insert(from.end(), { a, b, c });
+			to.insert(to.end(), { a1, b1, c1 });
+		}
+		std::cout << "ContinuousCollision queries failing against small steps: SphereTriangle " << sphereFailures << " of " << queries << " with " << sphereHits << " hits, PointMovingTriangle "
+			<< pointFailures << " of " << queries << " with " << pointHits << " hits\n";
+
+		size_t batchMismatches = 0;
+		for (int query = 0; query < 100; query++)
+		{
+			const Vector3 start = randomPoint(), end = randomPoint();
+			const float radius = 0.5f + unit(random);
+			ContinuousCollision::Contact expected{}, contact{};
+			bool expectedHit = false;
+			uint32_t expectedTriangle = 0, triangle = 0;
+			for (uint32_t i = 0; i < triangles.size(); i++)
+			{
+				ContinuousCollision::Contact single;
+				if (ContinuousCollision::SphereTriangle(single, start, end, radius, triangles[i].a, triangles[i].b, triangles[i].c) && (!expectedHit || single.time < expected.time))
+				{
+					expected = single;
+					expectedTriangle = i;
+					expectedHit = true;
+				}
+			}
+			bool hit = ContinuousCollision::SphereTriangles(contact, triangle, start, end, radius, triangles.data(), triangles.size());
+			if (hit != expectedHit || (hit && (contact.time != expected.time || triangle != expectedTriangle))) batchMismatches++;
+
+			expectedHit = false;
+			for (uint32_t i = 0; i < triangles.size(); i++)
+			{
+				ContinuousCollision::Contact single;
+				if (ContinuousCollision::PointMovingTriangle(single, start, end, from[i * 3], from[i * 3 + 1], from[i * 3 + 2], to[i * 3], to[i * 3 + 1], to[i * 3 + 2]) && (!expectedHit || single.time < expected.time))
+				{
+					expected = single;
+					expectedTriangle = i;
+					expectedHit = true;
+				}
+			}
+			hit = ContinuousCollision::PointMovingTriangles(contact, triangle, start, end, from.data(), to.data(), triangles.size());
+			if (hit != expectedHit || (hit && (contact.time != expected.time || triangle != expectedTriangle))) batchMismatches++;
+		}
+		std::cout << "ContinuousCollision batch mismatches against the earliest single query: " << batchMismatches << " of 200\n";
+	}
+
+	//ConcurrentGrid against testing every point, with four threads inserting single points and batches, half of them frozen and half still in the live lists
+	//One point in a thousand lies far outside the range of 32 bit cells, queries around them cover more cells than there are buckets
+	{
+		const unsigned threadCount = 4;
+		const size_t perThread = 20000;
+		ConcurrentGrid grid(0.5f, threadCount * perThread * 2, 1 << 12);
+		std::vector<std::vector<Vector3>> inserted(threadCount);
+		std::vector<std::vector<uint32_t>> ids(threadCount);
+		for (unsigned thread = 0; thread < threadCount; thread++)
+		{
+			for (size_t i = 0; i < perThread * 2; i++)
+			{
+				const float scale = i % 1000 == 0 ? 1e12f : 1;
+				inserted[thread].push_back(Vector3(coordinate(random), coordinate(random), coordinate(random)) * scale);
+			}
+		}
+
+		const auto insertHalf = [&](const size_t half)
+		{
+			std::vector<std::thread> threads;
+			for (unsigned thread = 0; thread < threadCount; thread++)
+			{
+				threads.emplace_back([&, thread, half]()
+				{
+					const Vector3* points = inserted[thread].data() + half * perThread;
+					for (size_t i = 0; i < perThread; i += 100)
+					{
+						if (i % 200 == 0)
+						{
+							const uint32_t first = grid.Insert(points + i, 100);
+							for (uint32_t j = 0; j < 100; j++)
+								ids[thread].push_back(first + j);
+						}
+						else
+						{
+							for (size_t j = i; j < i + 100; j++)
+								ids[thread].push_back(grid.Insert(points[j]));
+						}
+					}
+				});
+			}
+			for (std::thread& thread : threads)
+				thread.join();
+		};
+		insertHalf(0);
+		grid.Freeze();
+		insertHalf(1);
+
+		std::vector<std::pair<uint32_t, Vector3>> all;
+		for (unsigned thread = 0; thread < threadCount; thread++)
+			for (size_t i = 0; i < ids[thread].size(); i++)
+				all.emplace_back(ids[thread][i], inserted[thread][i]);
+
+		std::vector<Vector3> far;
+		for (const auto& point : all)
+			if (point.second.SqrMagnitude() > 1e12f) far.push_back(point.second);
+
+		size_t mismatches = 0;
+		const int queries = 300;
+		std::uniform_real_distribution<float> radius(0, 3);
+		std::vector<ConcurrentGrid::Hit> hits;
+		for (int query = 0; query < queries; query++)
+		{
+			const Vector3 center = query % 10 == 0 ? far[random() % far.size()] : Vector3(coordinate(random), coordinate(random), coordinate(random));
+			const float r = query % 10 == 0 ? 1e6f : radius(random);
+			hits.clear();
+			grid.Query(hits, center, r);
+
+			std::vector<uint32_t> found, expected;
+			for (const ConcurrentGrid::Hit& hit : hits)
+				found.push_back(hit.id);
+			for (const auto& point : all)
+				if ((point.second - center).SqrMagnitude() <= r * r) expected.push_back(point.first);
+			std::sort(found.begin(), found.end());
+			std::sort(expected.begin(), expected.end());
+			if (found != expected) mismatches++;
+		}
+		std::cout << "ConcurrentGrid queries whose hits differ from brute force: " << mismatches << " of " << queries << ", " << grid.Count() << " points, " << grid.FrozenCount() << " frozen\n";
+	}
+
+	//SharedPool against the data each version was built from, a reader thread with its own mapping checks every element of every lease it takes
+	//while the writer publishes new versions, so a bank overwritten under a lease shows up as a torn read
+	{
+		struct Root
+		{
+			uint64_t generation;
+			SharedArray<uint64_t> values;
+			SharedVector3Soa points;
+		};
+		const auto expectedValue = [](const uint64_t generation, const size_t i) { return generation * 1000003 + i; };
+		const auto expectedPoint = [](const uint64_t generation, const size_t i) { return Vector3(static_cast<float>(generation), static_cast<float>(i), static_cast<float>(generation + i)); };
+
+		const std::string name = "VectorSharedPoolCheck";
+		SharedPool writer, reader;
+		if (writer.Create(name, 1 << 22) && reader.Open(name))
+		{
+			std::atomic<bool> done(false);
+			size_t leases = 0, torn = 0;
+			std::thread readerThread([&]()
+			{
+				uint64_t last = 0;
+				while (!done.load() || last < writer.Generation())
+				{
+					const SharedPool::Lease lease = reader.Acquire();
+					if (!lease.Valid()) continue;
+					const Root& root = lease.GetRoot<Root>();
+					last = lease.Generation();
+					leases++;
+
+					bool intact = root.generation == lease.Generation() && root.values.count == root.points.x.count;
+					const uint64_t* values = lease.Get(root.values);
+					const float* x = lease.Get(root.points.x);
+					const float* y = lease.Get(root.points.y);
+					const float* z = lease.Get(root.points.z);
+					for (size_t i = 0; intact && i < root.values.count; i++)
+					{
+						const Vector3 expected = expectedPoint(root.generation, i);
+						intact = values[i] == expectedValue(root.generation, i) && x[i] == expected.x && y[i] == expected.y && z[i] == expected.z;
+					}
+					if (!intact) torn++;
+				}
+			});
+
+			const uint64_t versions = 200;
+			std::vector<Vector3> points;
+			for (uint64_t generation = 1; generation <= versions; generation++)
+			{
+				writer.Begin();
+				const size_t count = 1000 + generation * 37 % 5000;
+				Root root{ generation, writer.Allocate<uint64_t>(count), {} };
+				for (size_t i = 0; i < count; i++)
+					writer.Data(root.values)[i] = expectedValue(generation, i);
+				points.clear();
+				for (size_t i = 0; i < count; i++)
+					points.push_back(expectedPoint(generation, i));
+				root.points = writer.StoreSoa(points.data(), count);
+				writer.Publish(root);
+			}
+			done = true;
+			readerThread.join();
+			std::cout << "SharedPool leases whose data differs from the version they were published with: " << torn << " of " << leases << " over " << versions << " versions\n";
+			reader.Close();
+			writer.Close();
+			SharedPool::Remove(name);
+		}
+		else
+		{
+			std::cout << "SharedPool check skipped, shared memory is not available\n";
+			SharedPool::Remove(name);
+		}
+	}
+
+	//VectorMap against a linear search of every stored key, a new entry is inserted exactly when no stored key is within epsilon and any key found has to be within epsilon
+	//Points are jittered around a coarse grid so many land within epsilon of each other, at ordinary, huge and tiny scales and with epsilon of zero
+	{
+		size_t failures = 0, operations = 0;
+		std::uniform_real_distribution<float> jitter(-1, 1);
+		std::uniform_int_distribution<int> lattice(-5, 5);
+		for (const float scale : { 1.0f, 1e30f, 1e-30f })
+		{
+			for (const float epsilon : { 0.0f, 1e-3f, 0.3f })
+			{
+				const auto within = [epsilon, scale](const Vector3& lhs, const Vector3& rhs)
+				{
+					if (epsilon == 0) return VectorEqual()(lhs, rhs);
+					const double x = static_cast<double>(lhs.x) - rhs.x, y = static_cast<double>(lhs.y) - rhs.y, z = static_cast<double>(lhs.z) - rhs.z;
+					return x * x + y * y + z * z <= static_cast<double>(epsilon * scale) * (epsilon * scale);
+				};
+				const auto randomKey = [&]()
+				{
+					const float spread = epsilon > 0 ? epsilon : 0.25f;
+					return Vector3(lattice(random) + jitter(random) * spread, lattice(random) + jitter(random) * spread, lattice(random) + jitter(random) * spread) * scale;
+				};
+
+				VectorMap<Vector3, uint32_t> map(epsilon * scale);
+				std::vector<Vector3> stored;
+				for (int i = 0; i < 2000; i++)
+				{
+					//Every other key is a stored one moved by up to epsilon on each axis, so it can fall on either side of the epsilon sphere
+					const Vector3 nudge = Vector3(jitter(random), jitter(random), jitter(random)) * (epsilon * scale);
+					const Vector3 key = i % 2 == 0 || stored.empty() ? randomKey() : stored[random() % stored.size()] + nudge;
+					const bool expectedNew = std::none_of(stored.begin(), stored.end(), [&](const Vector3& other) { return within(other, key); });
+
+					uint32_t index;
+					const bool inserted = map.Insert(index, key, static_cast<uint32_t>(i));
+					if (inserted != expectedNew || !within(map.Entries()[index].key, key)) failures++;
+					if (inserted) stored.push_back(key);
+
+					const Vector3 query = randomKey();
+					const bool expectedFound = std::any_of(stored.begin(), stored.end(), [&](const Vector3& other) { return within(other, query); });
+					const uint32_t found = map.Find(query);
+					if ((found != VectorMap<Vector3, uint32_t>::invalid) != expectedFound || (expectedFound && !within(map.Entries()[found].key, query))) failures++;
+					operations += 2;
+				}
+			}
+		}
+		std::cout << "VectorMap inserts and finds differing from a linear search: " << failures << " of " << operations << "\n";
+	}
+
+	std::cout << "\n\n";
+
+	//Accuracy of every function against a long double reference, together with its throughput
+	AccuracyHarness harness;
+	harness.RegisterDefaults();
+	AccuracyHarness::Print(std::cout, harness.Run(1 << 12));
+
 	std::cout << "\n\n";
 	return 0;
 }
\ No newline at end of file